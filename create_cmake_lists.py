@@ -33,6 +33,7 @@ def createBuildScript(clientSources, serverSources, includeDirs):
     file.write('add_subdirectory(deps/glfw)\n')
     file.write('add_subdirectory(deps/glm)\n')
     file.write('add_subdirectory(deps/stb-cmake)\n')
+    file.write('find_package(Threads REQUIRED)\n')
 
     file.write('add_executable(client')
     for f in clientSources:
@@ -53,6 +54,7 @@ def createBuildScript(clientSources, serverSources, includeDirs):
     file.write('target_link_libraries(client PUBLIC stb-cmake)\n')
     file.write('target_link_libraries(client PUBLIC glfw)\n')
     file.write('target_link_libraries(client PUBLIC glm)\n')
+    file.write('target_link_libraries(client PUBLIC Threads::Threads)\n')
     file.write('target_link_libraries(server PUBLIC net-cmake)\n')
 
     file.close()
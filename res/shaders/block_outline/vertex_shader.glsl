@@ -2,8 +2,11 @@
 
 layout (location = 0) in vec3 in_position;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera {
+	mat4 projection;
+	mat4 view;
+	vec4 cameraPosition;
+};
 uniform vec3 blockPosition;
 
 void main(){
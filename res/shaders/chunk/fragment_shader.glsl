@@ -11,7 +11,12 @@ out vec4 out_color;
 uniform sampler2DArray textureMap;
 
 void main() {
-	out_color = texture(textureMap, textureData);
+	// The texture coordinates aren't wrapped per block, the gradients of the unwrapped ones keep fract() from picking the smallest mip level at block edges
+	vec2 faceCoords = textureData.xy;
+	out_color = textureGrad(textureMap, vec3(fract(faceCoords), textureData.z), dFdx(faceCoords), dFdy(faceCoords));
+#ifdef CUTOUT
+	// Only compiled into the cutout pass, a discard anywhere in the shader can turn off early depth testing
 	if(out_color.a < 0.5) discard;
+#endif
 	out_color = vec4(out_color.rgb * pass_AO, 1.0);
 }
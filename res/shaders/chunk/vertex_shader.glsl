@@ -1,25 +1,44 @@
 #version 330 core
 
-// Ins
-layout (location = 0) in uint vertexData;
+#ifdef MULTI_DRAW
+#extension GL_ARB_shader_draw_parameters : require
+#endif
+
+// Ins, one packed face per instance, see ChunkMesher.hpp for the layout
+layout (location = 0) in uint faceData;
+layout (location = 1) in uint faceSize;
 
 // Outs
 out float pass_AO;
 out vec3 textureData;
 
 //Uniforms
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera {
+	mat4 projection;
+	mat4 view;
+	vec4 cameraPosition;
+};
+#ifdef MULTI_DRAW
+// One origin per draw command, see MultiDrawRenderer
+layout (std430, binding = 0) readonly buffer ChunkOrigins {
+	vec4 chunkOrigins[];
+};
+#else
 uniform vec3 chunkPosition;
-uniform vec3 cameraPosition;
+#endif
+uniform bool greedyMeshing;
 
 // Constants
-vec2 texCoords[4] = vec2[4](
-    vec2(0.0f, 1.0f),
-    vec2(0.0f, 0.0f),
-    vec2(1.0f, 0.0f),
-    vec2(1.0f, 1.0f)
+// Corners of every face in winding order, the first and the third one are on the diagonal of a normal quad
+const vec3 faceCorners[24] = vec3[24](
+	vec3(0, 1, 0), vec3(0, 1, 1), vec3(1, 1, 1), vec3(1, 1, 0), // Top
+	vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 0, 1), vec3(0, 0, 1), // Bottom
+	vec3(0, 0, 0), vec3(0, 0, 1), vec3(0, 1, 1), vec3(0, 1, 0), // Right (-x)
+	vec3(1, 0, 0), vec3(1, 1, 0), vec3(1, 1, 1), vec3(1, 0, 1), // Left (+x)
+	vec3(0, 0, 0), vec3(0, 1, 0), vec3(1, 1, 0), vec3(1, 0, 0), // Front (-z)
+	vec3(0, 0, 1), vec3(1, 0, 1), vec3(1, 1, 1), vec3(0, 1, 1)  // Back (+z)
 );
+const int quadCorners[6] = int[6](0, 1, 2, 0, 2, 3);
 
 float calcVisibility(float d, float density, float gradient){
 	return clamp(exp(-pow((d*density), gradient)), 0.0, 1.0);
@@ -35,22 +54,38 @@ float map(float value, float min1, float max1, float min2, float max2) {
 
 void main(){
 
-	// Extracting information position
-	float x = float(vertexData & 0x3Fu);
-	float y = float((vertexData & 0xFC0u) >> 6u);
-	float z = float((vertexData & 0x3F000u) >> 12u);
-	float basicLight = float((vertexData & 0x1C0000u) >> 18u);
-	uint coordIndex = (vertexData & 0x600000u) >> 21u;
-	uint arrayIndex = (vertexData & 0xFF800000u) >> 23u;
+	// Extracting information from the face
+	vec3 blockPosition = vec3(float(faceData & 0x1Fu), float((faceData >> 5u) & 0x1Fu), float((faceData >> 10u) & 0x1Fu));
+	uint face = (faceData >> 15u) & 0x7u;
+	uint ao[4] = uint[4]((faceData >> 18u) & 0x3u, (faceData >> 20u) & 0x3u, (faceData >> 22u) & 0x3u, (faceData >> 24u) & 0x3u);
+	uint arrayIndex = faceData >> 26u;
+
+	// The quad gets split along the diagonal with the brighter corners so AO interpolates without creases
+	int corner = quadCorners[gl_VertexID];
+	if(ao[0] + ao[2] <= ao[1] + ao[3]) corner = (corner + 3) % 4;
+
+	vec3 size = vec3(1.0);
+	if(greedyMeshing){
+		size = vec3(float(faceSize & 0x3Fu), float((faceSize >> 6u) & 0x3Fu), float((faceSize >> 12u) & 0x3Fu));
+	}
+	vec3 localPosition = blockPosition + faceCorners[face * 4u + uint(corner)] * size;
 
-	vec3 worldPosition = vec3(x, y, z) + chunkPosition;
+#ifdef MULTI_DRAW
+	vec3 chunkPosition = chunkOrigins[gl_DrawIDARB].xyz;
+#endif
+	vec3 worldPosition = localPosition + chunkPosition;
 	gl_Position = projection * view * vec4(worldPosition, 1.0);
-	textureData = vec3(texCoords[coordIndex], arrayIndex);
+
+	// Texture coordinates come from the position so the texture repeats once per block across merged quads
+	vec2 faceCoords;
+	if(face >= 2u && face < 4u) faceCoords = vec2(localPosition.z, -localPosition.y);
+	else if(face < 2u) faceCoords = vec2(localPosition.x, -localPosition.z);
+	else faceCoords = vec2(localPosition.x, -localPosition.y);
+	textureData = vec3(faceCoords, arrayIndex);
 
 	// Calculating AO and Fog
-	float d = distance(worldPosition, cameraPosition);
-	pass_AO = map(basicLight, 0, 3, 0.2, 1.0);
+	float d = distance(worldPosition, cameraPosition.xyz);
+	pass_AO = map(float(ao[corner]), 0, 3, 0.2, 1.0);
 	pass_AO = calcAO(pass_AO, d);
 
 }
-
@@ -4,10 +4,14 @@ layout (location = 0) in vec3 position;
 
 out vec3 textureCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera {
+	mat4 projection;
+	mat4 view;
+	vec4 cameraPosition;
+};
 
 void main(){
     textureCoords = position;
-    gl_Position = projection * view * vec4(position, 1.0);
+    // Only the rotation of the view, so the sky stays around the camera
+    gl_Position = projection * mat4(mat3(view)) * vec4(position, 1.0);
 }
@@ -6,8 +6,11 @@ layout (location = 2) in float size;
 
 out float pass_textureIndex;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera {
+	mat4 projection;
+	mat4 view;
+	vec4 cameraPosition;
+};
 uniform float screenWidth;
 
 void main(){
@@ -33,6 +33,7 @@ void Camera::update() {
 	m_forward = glm::normalize(m_forward);
 
 	m_viewMatrix = glm::lookAt(m_position, m_position + m_forward, glm::vec3(0.0f, 1.0f, 0.0f));
+	m_frustum.update(m_projectionMatrix * m_viewMatrix);
 }
 
 const glm::mat4& Camera::getViewMatrix() const {
@@ -55,6 +56,10 @@ const glm::vec3& Camera::getForward() const {
 	return m_forward;
 }
 
+const Frustum& Camera::getFrustum() const {
+	return m_frustum;
+}
+
 void Camera::setForward(const glm::vec3& forward) {
 	m_forward = forward;
 }
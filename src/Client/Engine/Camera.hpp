@@ -2,6 +2,7 @@
 
 #include "Chunk.hpp"
 #include "InputManager.hpp"
+#include "Frustum.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 
 class Camera {
@@ -16,6 +17,8 @@ public:
 	const glm::mat4& getViewMatrix() const;
 	const glm::vec3& getPosition() const;
 	const glm::vec3& getForward() const;
+	// Follows the view matrix, so it's only up to date after update()
+	const Frustum& getFrustum() const;
 	void setForward(const glm::vec3&);
 	void setPosition(const glm::vec3& vec);
 
@@ -27,6 +30,7 @@ private:
 	glm::vec3 m_forward;
 	glm::mat4 m_projectionMatrix;
 	glm::mat4 m_viewMatrix;
+	Frustum m_frustum;
 
 };
 
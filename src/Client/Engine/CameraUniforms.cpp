@@ -0,0 +1,27 @@
+#include "CameraUniforms.hpp"
+
+void CameraUniforms::init(){
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	// Stays bound, nothing else uses this binding point
+	glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORM_BINDING, m_bufferID);
+}
+
+void CameraUniforms::update(const Camera& _camera){
+	CameraBlock block;
+	block.projection = _camera.getProjectionMatrix();
+	block.view = _camera.getViewMatrix();
+	block.cameraPosition = glm::vec4(_camera.getPosition(), 1.0f);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &block);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void CameraUniforms::destroy(){
+	glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UNIFORM_BINDING, 0);
+	glDeleteBuffers(1, &m_bufferID);
+	m_bufferID = 0;
+}
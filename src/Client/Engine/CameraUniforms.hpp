@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Camera.hpp"
+#include "Shader.hpp"
+#include <GLAD/glad.h>
+#include <glm/glm.hpp>
+
+// The camera data every shader that draws the world needs, uploaded once per frame to a uniform buffer instead of to
+// each shader. Shaders get it by declaring
+//	layout (std140) uniform Camera {
+//		mat4 projection;
+//		mat4 view;
+//		vec4 cameraPosition; // w is unused
+//	};
+// which Shader::load binds to CAMERA_UNIFORM_BINDING
+class CameraUniforms {
+public:
+
+	void init();
+	// Has to be called after the camera has been updated and before anything that uses the block gets drawn
+	void update(const Camera& _camera);
+	void destroy();
+
+private:
+
+	// Same layout as the block under std140
+	struct CameraBlock {
+		glm::mat4 projection;
+		glm::mat4 view;
+		glm::vec4 cameraPosition;
+	};
+
+	GLuint m_bufferID = 0;
+
+};
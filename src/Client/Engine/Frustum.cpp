@@ -0,0 +1,70 @@
+#include "Frustum.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE2
+#include <emmintrin.h>
+#endif
+
+void Frustum::update(const glm::mat4& _viewProjection){
+	// glm is column major, so the rows of the matrix have to be put together first
+	glm::vec4 rows[4];
+	for(unsigned int i = 0; i < 4; i++){
+		rows[i] = glm::vec4(_viewProjection[0][i], _viewProjection[1][i], _viewProjection[2][i], _viewProjection[3][i]);
+	}
+	m_planes[0] = rows[3] + rows[0]; // Left
+	m_planes[1] = rows[3] - rows[0]; // Right
+	m_planes[2] = rows[3] + rows[1]; // Bottom
+	m_planes[3] = rows[3] - rows[1]; // Top
+	m_planes[4] = rows[3] + rows[2]; // Near
+	m_planes[5] = rows[3] - rows[2]; // Far
+}
+
+const glm::vec4& Frustum::getPlane(unsigned int _plane) const {
+	return m_planes[_plane];
+}
+
+void Frustum::cullCubes(const float* _x, const float* _y, const float* _z, unsigned int _count, float _size, uint8_t* _visible) const {
+	// A cube is outside a plane when its corner furthest along the normal is. Since every cube has the same size, the
+	// offset from the lowest corner to that one is the same for all of them and can be folded into the plane distance
+	float distances[6];
+	for(unsigned int i = 0; i < 6; i++){
+		const glm::vec4& p = m_planes[i];
+		distances[i] = p.w + (p.x > 0.0f ? p.x : 0.0f) * _size + (p.y > 0.0f ? p.y : 0.0f) * _size + (p.z > 0.0f ? p.z : 0.0f) * _size;
+	}
+
+	unsigned int i = 0;
+#ifdef FRUSTUM_SSE2
+	for(; i + 4 <= _count; i += 4){
+		__m128 x = _mm_loadu_ps(&_x[i]);
+		__m128 y = _mm_loadu_ps(&_y[i]);
+		__m128 z = _mm_loadu_ps(&_z[i]);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for(unsigned int j = 0; j < 6; j++){
+			const glm::vec4& p = m_planes[j];
+			__m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(p.x)), _mm_mul_ps(y, _mm_set1_ps(p.y)));
+			d = _mm_add_ps(d, _mm_mul_ps(z, _mm_set1_ps(p.z)));
+			d = _mm_add_ps(d, _mm_set1_ps(distances[j]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+		}
+		int mask = _mm_movemask_ps(inside);
+		_visible[i] = mask & 1;
+		_visible[i + 1] = (mask >> 1) & 1;
+		_visible[i + 2] = (mask >> 2) & 1;
+		_visible[i + 3] = (mask >> 3) & 1;
+	}
+#endif
+	for(; i < _count; i++){
+		bool inside = true;
+		for(unsigned int j = 0; j < 6; j++){
+			const glm::vec4& p = m_planes[j];
+			inside &= (p.x * _x[i]) + (p.y * _y[i]) + (p.z * _z[i]) + distances[j] >= 0.0f;
+		}
+		_visible[i] = inside;
+	}
+}
+
+bool Frustum::isCubeVisible(const glm::vec3& _corner, float _size) const {
+	uint8_t visible = 0;
+	cullCubes(&_corner.x, &_corner.y, &_corner.z, 1, _size, &visible);
+	return visible;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// The 6 planes of a view frustum with their normals pointing inwards, a point p is inside when
+// dot(plane.xyz, p) + plane.w >= 0 for every plane. The planes aren't normalized since only the sign matters.
+// Until the first update every plane is 0, which lets everything through
+class Frustum {
+public:
+
+	// Pulls the planes out of the combined projection * view matrix
+	void update(const glm::mat4& _viewProjection);
+	const glm::vec4& getPlane(unsigned int _plane) const;
+
+	// Tests _count cubes with an edge length of _size, given by their lowest corners as separate x, y and z arrays
+	// so 4 of them get tested at once. _visible[i] is set to 1 when cube i is at least partly inside, 0 otherwise.
+	// Cubes that are outside but still touch the corner of two planes can pass, that's the usual price of the plane test
+	void cullCubes(const float* _x, const float* _y, const float* _z, unsigned int _count, float _size, uint8_t* _visible) const;
+	// The same test for a single cube
+	bool isCubeVisible(const glm::vec3& _corner, float _size) const;
+
+private:
+
+	glm::vec4 m_planes[6] = {};
+
+};
@@ -0,0 +1,110 @@
+#include "MappedFile.hpp"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile(){
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& _path){
+	close();
+
+	HANDLE file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){
+		std::cout << "MappedFile: Could not open file: " << _path << std::endl;
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart == 0){
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(!mapping){
+		std::cout << "MappedFile: Could not map file: " << _path << std::endl;
+		CloseHandle(file);
+		return false;
+	}
+
+	m_data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(!m_data){
+		std::cout << "MappedFile: Could not map file: " << _path << std::endl;
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	m_size = size.QuadPart;
+	return true;
+}
+
+void MappedFile::close(){
+	if(m_data) UnmapViewOfFile(m_data);
+	if(m_mappingHandle) CloseHandle(m_mappingHandle);
+	if(m_fileHandle) CloseHandle(m_fileHandle);
+	m_data = nullptr;
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+	m_size = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& _path){
+	close();
+
+	int fd = ::open(_path.c_str(), O_RDONLY);
+	if(fd < 0){
+		std::cout << "MappedFile: Could not open file: " << _path << std::endl;
+		return false;
+	}
+
+	struct stat info;
+	if(fstat(fd, &info) || info.st_size == 0){
+		::close(fd);
+		return false;
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(data == MAP_FAILED){
+		std::cout << "MappedFile: Could not map file: " << _path << std::endl;
+		return false;
+	}
+
+	m_data = (const uint8_t*)data;
+	m_size = info.st_size;
+	return true;
+}
+
+void MappedFile::close(){
+	if(m_data) munmap((void*)m_data, m_size);
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
+
+const uint8_t* MappedFile::getData() const {
+	return m_data;
+}
+
+size_t MappedFile::getSize() const {
+	return m_size;
+}
@@ -4,11 +4,11 @@
 
 const float GRAVITY = 28.0f;
 
-void ParticleHandler::init(TextureArray* _array, BlockTextureHandler* _textureHandler){
-	m_blockTextureHandler = _textureHandler;
+void ParticleHandler::init(TextureArray* _array){
 	m_textureArray = _array;
 	m_quad.init();
 	m_shader.load("particle");
+	m_screenWidthUniform = m_shader.getUniform<float>("screenWidth");
 }
 
 void ParticleHandler::update(float deltaTime){
@@ -23,7 +23,7 @@ void ParticleHandler::update(float deltaTime){
 	}
 }
 
-void ParticleHandler::render(Camera& camera){
+void ParticleHandler::render(){
 	// Gathering particle data and sending it to GPU
 	m_particleInstances.resize(0);
 	for(unsigned int i = 0; i < m_particles.size(); i++){
@@ -37,9 +37,7 @@ void ParticleHandler::render(Camera& camera){
 	// Since we are rendering the particles as GL_POINTS, this uniform variable is necessary 
 	// in order to scale the particles based on the width of the screen. Otherwise the particles
 	// will have a fixed size regardless of screen size.
-	m_shader.loadUniform("screenWidth", InputManager::getWindowSize().x);
-	m_shader.loadUniform("projection", camera.getProjectionMatrix());
-	m_shader.loadUniform("view", camera.getViewMatrix());
+	m_shader.loadUniform(m_screenWidthUniform, InputManager::getWindowSize().x);
 
 	m_textureArray->bind();
 
@@ -67,13 +65,13 @@ float rndm(){
 }
 
 void ParticleHandler::placeParticlesAroundBlock(int x, int y, int z, uint8_t _blockID){
-	BlockTexture b = m_blockTextureHandler->getTextureFromBlockID(_blockID);
+	const BlockInfo& b = getBlockInfo(_blockID);
 
 	for(unsigned int i = 0; i < PARTICLES_PER_DROP; i++) {
 		glm::vec3 pos(x + rndm(), y + rndm(), z + rndm());
 		glm::vec3 direction = pos - (glm::vec3(x, y, z) + glm::vec3(0.5f, 0.0f, 0.5f));
 		glm::vec3 velocity = glm::vec3(direction.x * 3.0f, direction.y * 4.0f, direction.z * 3.0f);
-		m_particles.emplace_back(Particle(pos, velocity, 1.0f, getRandom(b.bot, b.side, b.top), 100.0f + rndm() * 100.0f));
+		m_particles.emplace_back(Particle(pos, velocity, 1.0f, getRandom(b.textures[FACE_BOTTOM], b.textures[FACE_RIGHT], b.textures[FACE_TOP]), 100.0f + rndm() * 100.0f));
 	}
 }
 
@@ -4,7 +4,7 @@
 #include "Shader.hpp"
 #include "Camera.hpp"
 #include "TextureArray.hpp"
-#include "BlockTextureHandler.hpp"
+#include "BlockRegistry.hpp"
 #include <vector>
 
 const unsigned int PARTICLES_PER_DROP = 50;
@@ -45,9 +45,9 @@ struct ParticleInstance {
 class ParticleHandler {
 public:
 
-	void init(TextureArray* _array, BlockTextureHandler* _textureHandler);
+	void init(TextureArray* _array);
 	void update(float deltaTime);
-	void render(Camera& camera);
+	void render();
 	void destroy();
 
 	void placeParticlesAroundBlock(int x, int y, int z, uint8_t _blockID);
@@ -58,8 +58,8 @@ private:
 	std::vector<ParticleInstance> m_particleInstances;
 	ParticleQuad m_quad;
 	TextureArray* m_textureArray = nullptr;
-	BlockTextureHandler* m_blockTextureHandler = nullptr;
 	Shader m_shader;
+	Uniform<float> m_screenWidthUniform;
 
 };
 
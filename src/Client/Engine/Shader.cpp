@@ -1,8 +1,29 @@
 #include "Shader.hpp"
 #include "Utils.hpp"
 #include "FilePathManager.hpp"
+#include <algorithm>
 
-void Shader::load(const std::string& name){
+// The defines have to go after the #version line, which must come first
+void addDefines(std::string& code, const std::vector<std::string>& defines, const std::string& version){
+	std::string lines;
+	for(auto& define : defines){
+		lines += "#define " + define + "\n";
+	}
+	size_t versionEnd = code.find('\n');
+	if(versionEnd == std::string::npos){
+		versionEnd = code.size();
+	} else {
+		versionEnd++;
+	}
+	if(!version.empty()){
+		lines = "#version " + version + "\n" + lines;
+		code.erase(0, versionEnd);
+		versionEnd = 0;
+	}
+	code.insert(versionEnd, lines);
+}
+
+void Shader::load(const std::string& name, const std::vector<std::string>& defines, const std::string& version){
 	std::string vs = FilePathManager::getRootFolderDirectory() + "res/shaders/" + name + "/vertex_shader.glsl";
 	std::string fs = FilePathManager::getRootFolderDirectory() + "res/shaders/" + name + "/fragment_shader.glsl";
 
@@ -11,6 +32,8 @@ void Shader::load(const std::string& name){
 
 	std::string vsCode = Utils::readFileToString(vs);
 	std::string fsCode = Utils::readFileToString(fs);
+	addDefines(vsCode, defines, version);
+	addDefines(fsCode, defines, version);
 
 	const char* vs_pointer = vsCode.c_str();
 	const char* fs_pointer = fsCode.c_str();
@@ -38,6 +61,33 @@ void Shader::load(const std::string& name){
 	glAttachShader(m_programID, m_fragmentID);
 	glLinkProgram(m_programID);
 	glValidateProgram(m_programID);
+
+	// Looking up every uniform once, so setting them never has to ask the driver
+	m_uniforms.clear();
+	GLint numUniforms = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &numUniforms);
+	glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	std::vector<GLchar> nameBuffer(std::max(maxNameLength, 1));
+	for(GLint i = 0; i < numUniforms; i++){
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(m_programID, i, nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+		std::string uniformName(nameBuffer.data(), length);
+		GLint location = glGetUniformLocation(m_programID, uniformName.c_str());
+		if(location == -1) continue; // Part of a uniform block
+		// Arrays are listed as their first element
+		if(uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0){
+			uniformName.resize(uniformName.size() - 3);
+		}
+		m_uniforms[uniformName] = { location, type };
+	}
+
+	GLuint cameraBlock = glGetUniformBlockIndex(m_programID, "Camera");
+	if(cameraBlock != GL_INVALID_INDEX){
+		glUniformBlockBinding(m_programID, cameraBlock, CAMERA_UNIFORM_BINDING);
+	}
 }
 
 void Shader::bind(){
@@ -56,33 +106,56 @@ void Shader::destroy(){
 	glDeleteProgram(m_programID);
 }
 
-GLint Shader::getUniformLocation(const std::string& name){
-	auto it = m_uniformLocations.find(name);
-	if(it == m_uniformLocations.end()){
-		GLint location = glGetUniformLocation(m_programID, name.c_str());
-		m_uniformLocations[name] = location;
-		return location;
+GLint Shader::findUniform(const std::string& name, GLenum type) const {
+	auto it = m_uniforms.find(name);
+	if(it == m_uniforms.end()){
+		std::cout << "Shader: No active uniform called " << name << std::endl;
+		return -1;
 	}
-	return it->second;
+	if(it->second.type != type){
+		std::cout << "Shader: Uniform " << name << " has a different type than it's set with" << std::endl;
+		return -1;
+	}
+	return it->second.location;
+}
+
+void Shader::loadUniform(Uniform<glm::vec3> uniform, const glm::vec3& vec){
+	glUniform3fv(uniform.location, 1, &vec.x);
+}
+
+void Shader::loadUniform(Uniform<glm::mat4> uniform, const glm::mat4& matrix){
+	glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &matrix[0][0]);
+}
+
+void Shader::loadUniform(Uniform<float> uniform, float f){
+	glUniform1f(uniform.location, f);
+}
+
+void Shader::loadUniform(Uniform<int> uniform, int i){
+	glUniform1i(uniform.location, i);
+}
+
+void Shader::loadUniform(Uniform<bool> uniform, bool b){
+	int value = (int)b;
+	glUniform1i(uniform.location, value);
 }
 
 void Shader::loadUniform(const std::string& name, const glm::vec3& vec){
-	glUniform3fv(getUniformLocation(name), 1, &vec.x);
+	loadUniform(getUniform<glm::vec3>(name), vec);
 }
 
 void Shader::loadUniform(const std::string& name, const glm::mat4& matrix){
-	glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
+	loadUniform(getUniform<glm::mat4>(name), matrix);
 }
 
 void Shader::loadUniform(const std::string& name, float f){
-	glUniform1f(getUniformLocation(name), f);
+	loadUniform(getUniform<float>(name), f);
 }
 
 void Shader::loadUniform(const std::string& name, int i){
-	glUniform1i(getUniformLocation(name), i);
+	loadUniform(getUniform<int>(name), i);
 }
 
 void Shader::loadUniform(const std::string& name, bool b){
-	int value = (int)b;
-	glUniform1i(getUniformLocation(name), value);
+	loadUniform(getUniform<bool>(name), b);
 }
\ No newline at end of file
@@ -4,16 +4,50 @@
 #include <string>
 #include <fstream>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
+// Binding point of the Camera uniform block, which load() binds in every shader that declares it. See CameraUniforms
+const GLuint CAMERA_UNIFORM_BINDING = 0;
+
+// GL type a uniform has to be declared with to be set as a T
+template<typename T> inline constexpr GLenum UNIFORM_TYPE = 0;
+template<> inline constexpr GLenum UNIFORM_TYPE<glm::vec3> = GL_FLOAT_VEC3;
+template<> inline constexpr GLenum UNIFORM_TYPE<glm::mat4> = GL_FLOAT_MAT4;
+template<> inline constexpr GLenum UNIFORM_TYPE<float> = GL_FLOAT;
+template<> inline constexpr GLenum UNIFORM_TYPE<int> = GL_INT;
+template<> inline constexpr GLenum UNIFORM_TYPE<bool> = GL_BOOL;
+
+// Location of a uniform, looked up once after load() so setting it in a loop doesn't go through its name.
+// Setting one that isn't in the shader does nothing, like glUniform with a location of -1
+template<typename T>
+struct Uniform {
+	GLint location = -1;
+};
+
 class Shader {
 public:
 
-	void load(const std::string& name);
+	// Every define gets added as a #define line to both shaders, for compiling variants of the same source.
+	// A version replaces the one of the #version lines, for variants that need a newer GLSL
+	void load(const std::string& name, const std::vector<std::string>& defines = {}, const std::string& version = "");
 	void bind();
 	void unbind();
 	void destroy();
 
+	// Prints a warning when the shader has no active uniform called name, or it isn't declared as a T
+	template<typename T>
+	Uniform<T> getUniform(const std::string& name) const {
+		return { findUniform(name, UNIFORM_TYPE<T>) };
+	}
+
+	void loadUniform(Uniform<glm::vec3> uniform, const glm::vec3& vec);
+	void loadUniform(Uniform<glm::mat4> uniform, const glm::mat4& matrix);
+	void loadUniform(Uniform<float> uniform, float f);
+	void loadUniform(Uniform<int> uniform, int i);
+	void loadUniform(Uniform<bool> uniform, bool b);
+
+	// For uniforms that are only set once in a while, the ones set every frame should use a Uniform
 	void loadUniform(const std::string& name, const glm::vec3& vec);
 	void loadUniform(const std::string& name, const glm::mat4& matrix);
 	void loadUniform(const std::string& name, float f);
@@ -22,9 +56,14 @@ public:
 
 private:
 
-	GLint getUniformLocation(const std::string& name);
+	struct ActiveUniform {
+		GLint location;
+		GLenum type;
+	};
+
+	GLint findUniform(const std::string& name, GLenum type) const;
 
-	std::unordered_map<std::string, GLint> m_uniformLocations;
+	std::unordered_map<std::string, ActiveUniform> m_uniforms; // Every active uniform outside of blocks, filled by load()
 
 	GLuint m_programID = 0;
 	GLuint m_vertexID = 0;
@@ -7,7 +7,8 @@ class Skybox {
 public:
 
 	void init();
-	void render(const glm::mat4& _projection, glm::mat4 view);
+	// Uses the Camera uniform block, see CameraUniforms
+	void render();
 	void destroy();
 
 private:
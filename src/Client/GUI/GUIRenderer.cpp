@@ -5,6 +5,7 @@ SpriteBatch m_guiBatch;
 SpriteBatch m_textBatch;
 SpriteFont m_spriteFont;
 Shader m_shader;
+Uniform<bool> m_isFontUniform;
 
 void GUIRenderer::init(unsigned int windowWidth, unsigned int windowHeight, GLuint textureID){
 	m_spriteFont.init(FilePathManager::getRootFolderDirectory() + "res/fonts/minecraft_font.ttf", 40, 512, 512);
@@ -14,6 +15,7 @@ void GUIRenderer::init(unsigned int windowWidth, unsigned int windowHeight, GLui
 	glm::mat4 ortho = glm::ortho(0.0f, (float)windowWidth, 0.0f, (float)windowHeight);
 
 	m_shader.load("sprite");
+	m_isFontUniform = m_shader.getUniform<bool>("isFont");
 	m_shader.bind();
 	m_shader.loadUniform("matrix", ortho);
 	m_shader.unbind();
@@ -37,9 +39,9 @@ void GUIRenderer::render(){
 	glDisable(GL_DEPTH_TEST);
 
 	m_shader.bind();
-	m_shader.loadUniform("isFont", false);
+	m_shader.loadUniform(m_isFontUniform, false);
 	m_guiBatch.render();
-	m_shader.loadUniform("isFont", true);
+	m_shader.loadUniform(m_isFontUniform, true);
 	m_textBatch.render();
 	m_shader.unbind();
 
@@ -3,10 +3,12 @@
 void BlockOutline::init(){
 	m_outline.init();
 	m_shader.load("block_outline");
+	m_blockPositionUniform = m_shader.getUniform<glm::vec3>("blockPosition");
+	m_legacyOutlineUniform = m_shader.getUniform<bool>("legacyOutline");
 	m_legacyOutline.init();
 }
 
-void BlockOutline::render(Player* player, Camera& camera, bool _legacyOutline){
+void BlockOutline::render(Player* player, bool _legacyOutline){
 	//Checking if the player is facing a block in order to draw an outline
 	if(!player->visibleBlocks.lookingAtBlock) return;
 
@@ -16,12 +18,10 @@ void BlockOutline::render(Player* player, Camera& camera, bool _legacyOutline){
 
 	//Binding the shader, loading a couple uniforms and rendering a face based on the position of the block
 	m_shader.bind();
-	m_shader.loadUniform("projection", camera.getProjectionMatrix());
-	m_shader.loadUniform("view", camera.getViewMatrix());
 	glm::ivec3 bb = player->visibleBlocks.breakableBlock; // Getting the breakable block
 	glm::vec3 float_bb(bb.x, bb.y, bb.z); // Calculating the floating point version of the breakable block
-	m_shader.loadUniform("blockPosition", float_bb); // We send the position of the block to the vertex shader which will get added to the vertices and form a face
-	m_shader.loadUniform("legacyOutline", _legacyOutline);
+	m_shader.loadUniform(m_blockPositionUniform, float_bb); // We send the position of the block to the vertex shader which will get added to the vertices and form a face
+	m_shader.loadUniform(m_legacyOutlineUniform, _legacyOutline);
 	if(_legacyOutline){
 		m_legacyOutline.render();
 	}else{
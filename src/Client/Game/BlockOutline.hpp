@@ -19,7 +19,7 @@ class BlockOutline {
 public:
 
 	void init();
-	void render(Player* player, Camera& camera, bool _legacyOutline);
+	void render(Player* player, bool _legacyOutline);
 	void destroy();
 
 private:
@@ -31,5 +31,7 @@ private:
 	LegacyOutline m_legacyOutline;
 	FaceOutline m_outline;
 	Shader m_shader;
+	Uniform<glm::vec3> m_blockPositionUniform;
+	Uniform<bool> m_legacyOutlineUniform;
 
 };
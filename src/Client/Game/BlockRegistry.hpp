@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Every block type lives in BLOCK_DEFINITIONS below, adding a block only needs a new ID and a line there.
+// The definitions get expanded into a table of all 256 IDs at compile time, so looking up anything about a block
+// is a single load without a branch or a bounds check, which is what the mesher needs in its inner loops.
+
+// Block IDs
+const uint8_t BLOCK_AIR = 0;
+const uint8_t BLOCK_GRASS = 1;
+const uint8_t BLOCK_SNOW = 2;
+const uint8_t BLOCK_DIRT = 3;
+const uint8_t BLOCK_SAND = 4;
+const uint8_t BLOCK_STONE = 5;
+const uint8_t BLOCK_WOOD = 6;
+const uint8_t BLOCK_LEAVES = 7;
+const uint8_t BLOCK_CACTUS = 8;
+const uint8_t BLOCK_COBBLE = 9;
+const uint8_t BLOCK_DIAMOND = 10;
+
+// Block flags
+const uint8_t BLOCK_FLAG_SOLID = 1 << 0; // Collides with the player and can be targeted
+const uint8_t BLOCK_FLAG_OPAQUE = 1 << 1; // Hides the faces behind it
+const uint8_t BLOCK_FLAG_CUTOUT = 1 << 2; // Has see-through holes in its texture, see CHUNK_PASS_CUTOUT
+
+// Face directions, the naming of the x faces comes from the original face functions
+const unsigned int FACE_TOP = 0;
+const unsigned int FACE_BOTTOM = 1;
+const unsigned int FACE_RIGHT = 2; // Faces -x
+const unsigned int FACE_LEFT = 3; // Faces +x
+const unsigned int FACE_FRONT = 4; // Faces -z
+const unsigned int FACE_BACK = 5; // Faces +z
+
+// Where every face points, as x, y and z. Faces come in pairs, so the opposite one only differs in the lowest bit
+inline constexpr int FACE_OFFSETS[6][3] = { { 0, 1, 0 }, { 0, -1, 0 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+
+inline unsigned int getOppositeFace(unsigned int _face){
+	return _face ^ 1;
+}
+
+// Faces keep the texture layer in 6 bits, see ChunkMesher
+const unsigned int MAX_BLOCK_TEXTURE_LAYERS = 64;
+
+// 8 bytes, so the whole table takes up 2 KB and stays in the cache
+struct BlockInfo {
+	uint8_t flags = 0;
+	uint8_t textures[6] = {}; // Layer of the texture array for every face direction
+};
+
+struct BlockDefinition {
+	uint8_t id;
+	const char* name;
+	uint8_t flags;
+	// Layers of the texture array, every side face uses the same one
+	uint8_t top;
+	uint8_t side;
+	uint8_t bot;
+};
+
+const uint8_t FLAGS_OPAQUE_BLOCK = BLOCK_FLAG_SOLID | BLOCK_FLAG_OPAQUE;
+const uint8_t FLAGS_CUTOUT_BLOCK = BLOCK_FLAG_SOLID | BLOCK_FLAG_CUTOUT;
+
+constexpr BlockDefinition BLOCK_DEFINITIONS[] = {
+	{ BLOCK_GRASS, "Grass", FLAGS_OPAQUE_BLOCK, 0, 1, 2 },
+	{ BLOCK_SNOW, "Snow", FLAGS_OPAQUE_BLOCK, 3, 4, 2 },
+	{ BLOCK_DIRT, "Dirt", FLAGS_OPAQUE_BLOCK, 2, 2, 2 },
+	{ BLOCK_SAND, "Sand", FLAGS_OPAQUE_BLOCK, 5, 5, 5 },
+	{ BLOCK_STONE, "Stone", FLAGS_OPAQUE_BLOCK, 6, 6, 6 },
+	{ BLOCK_WOOD, "Wood", FLAGS_OPAQUE_BLOCK, 7, 8, 7 },
+	{ BLOCK_LEAVES, "Leaves", FLAGS_CUTOUT_BLOCK, 9, 9, 9 },
+	{ BLOCK_CACTUS, "Cactus", FLAGS_OPAQUE_BLOCK, 10, 11, 10 },
+	{ BLOCK_COBBLE, "Cobble", FLAGS_OPAQUE_BLOCK, 12, 12, 12 },
+	{ BLOCK_DIAMOND, "Diamond", FLAGS_OPAQUE_BLOCK, 13, 13, 13 }
+};
+
+const unsigned int NUM_BLOCK_DEFINITIONS = sizeof(BLOCK_DEFINITIONS) / sizeof(BLOCK_DEFINITIONS[0]);
+
+// IDs without a definition are solid and opaque with the first texture, like the mesher's row masks treat every
+// non-air block that isn't in SEE_THROUGH_BLOCKS. Only air has no flags
+constexpr std::array<BlockInfo, 256> makeBlockTable(){
+	std::array<BlockInfo, 256> table = {};
+	for(unsigned int id = 1; id < 256; id++){
+		table[id].flags = FLAGS_OPAQUE_BLOCK;
+	}
+	for(const BlockDefinition& definition : BLOCK_DEFINITIONS){
+		BlockInfo& info = table[definition.id];
+		info.flags = definition.flags;
+		info.textures[FACE_TOP] = definition.top;
+		info.textures[FACE_BOTTOM] = definition.bot;
+		info.textures[FACE_RIGHT] = definition.side;
+		info.textures[FACE_LEFT] = definition.side;
+		info.textures[FACE_FRONT] = definition.side;
+		info.textures[FACE_BACK] = definition.side;
+	}
+	return table;
+}
+
+constexpr bool hasUniqueBlockIDs(){
+	bool used[256] = {};
+	for(const BlockDefinition& definition : BLOCK_DEFINITIONS){
+		if(!definition.id || used[definition.id]) return false;
+		used[definition.id] = true;
+	}
+	return true;
+}
+
+constexpr bool hasValidTextureLayers(){
+	for(const BlockDefinition& definition : BLOCK_DEFINITIONS){
+		if(definition.top >= MAX_BLOCK_TEXTURE_LAYERS || definition.side >= MAX_BLOCK_TEXTURE_LAYERS || definition.bot >= MAX_BLOCK_TEXTURE_LAYERS) return false;
+	}
+	return true;
+}
+
+static_assert(hasUniqueBlockIDs(), "Every block needs its own ID and 0 is air");
+static_assert(hasValidTextureLayers(), "Texture layers have to fit the 6 bits faces store them in");
+
+inline constexpr std::array<BlockInfo, 256> BLOCK_TABLE = makeBlockTable();
+
+inline const BlockInfo& getBlockInfo(uint8_t _blockID){
+	return BLOCK_TABLE[_blockID];
+}
+
+// Air and blocks like leaves let the faces behind them show
+inline bool isBlockTransparent(uint8_t _blockID){
+	return !(BLOCK_TABLE[_blockID].flags & BLOCK_FLAG_OPAQUE);
+}
+
+inline bool isBlockSolid(uint8_t _blockID){
+	return BLOCK_TABLE[_blockID].flags & BLOCK_FLAG_SOLID;
+}
+
+// Non-air blocks that don't hide the faces behind them. The mesher tests for them 8 blocks at a time,
+// so it needs them as a list instead of going through the table
+constexpr unsigned int countSeeThroughBlocks(){
+	unsigned int count = 0;
+	for(const BlockDefinition& definition : BLOCK_DEFINITIONS){
+		if(!(definition.flags & BLOCK_FLAG_OPAQUE)) count++;
+	}
+	return count;
+}
+
+const unsigned int NUM_SEE_THROUGH_BLOCKS = countSeeThroughBlocks();
+
+constexpr std::array<uint8_t, NUM_SEE_THROUGH_BLOCKS> makeSeeThroughBlocks(){
+	std::array<uint8_t, NUM_SEE_THROUGH_BLOCKS> blocks = {};
+	unsigned int count = 0;
+	for(const BlockDefinition& definition : BLOCK_DEFINITIONS){
+		if(!(definition.flags & BLOCK_FLAG_OPAQUE)) blocks[count++] = definition.id;
+	}
+	return blocks;
+}
+
+inline constexpr std::array<uint8_t, NUM_SEE_THROUGH_BLOCKS> SEE_THROUGH_BLOCKS = makeSeeThroughBlocks();
+
+// The row masks only know about the blocks in the list, every other non-air block has to hide what's behind it
+constexpr bool isSeeThroughListComplete(){
+	for(unsigned int id = 1; id < 256; id++){
+		bool isListed = false;
+		for(uint8_t seeThrough : SEE_THROUGH_BLOCKS){
+			isListed |= seeThrough == id;
+		}
+		if(isListed == (bool)(BLOCK_TABLE[id].flags & BLOCK_FLAG_OPAQUE)) return false;
+	}
+	return true;
+}
+
+static_assert(isSeeThroughListComplete(), "The table and SEE_THROUGH_BLOCKS have to agree on which blocks are opaque");
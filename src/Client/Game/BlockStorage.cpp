@@ -0,0 +1,406 @@
+#include "BlockStorage.hpp"
+#include "TTConfig.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <random>
+
+// Chunk blob codecs
+const uint8_t CODEC_PACKED = 0;
+const uint8_t CODEC_RLE = 1;
+const unsigned int BLOB_HEADER_SIZE = 4;
+
+// Returns the log2 of the number of bits needed to index a palette of the given size, or -1 if no bits are needed at all
+int getRequiredBitsLog2(unsigned int _paletteSize){
+	if(_paletteSize <= 1) return -1;
+	if(_paletteSize <= 2) return 0;
+	if(_paletteSize <= 4) return 1;
+	if(_paletteSize <= 16) return 2;
+	return 3;
+}
+
+unsigned int readPackedIndex(const uint64_t* _data, unsigned int _bitsLog2, unsigned int _index){
+	unsigned int indicesPerWordLog2 = 6 - _bitsLog2;
+	uint64_t word = _data[_index >> indicesPerWordLog2];
+	unsigned int shift = (_index & ((1u << indicesPerWordLog2) - 1)) << _bitsLog2;
+	return (word >> shift) & ((1ull << (1u << _bitsLog2)) - 1);
+}
+
+BlockStorage::BlockStorage() {
+	m_palette.push_back(0);
+	m_counts.push_back(CHUNK_SIZE);
+}
+
+uint8_t BlockStorage::get(unsigned int _index) const {
+	if(isUniform()) return m_palette[0];
+	return m_palette[readIndex(_index)];
+}
+
+void BlockStorage::set(unsigned int _index, uint8_t _block) {
+	unsigned int oldIndex = isUniform() ? 0 : readIndex(_index);
+	if(m_palette[oldIndex] == _block) return;
+
+	unsigned int newIndex = getPaletteIndex(_block);
+	writeIndex(_index, newIndex);
+	m_counts[oldIndex]--;
+	m_counts[newIndex]++;
+
+	// Every block is the same again, so the index data can go
+	if(m_counts[newIndex] == CHUNK_SIZE) fill(_block);
+}
+
+void BlockStorage::setRun(unsigned int _index, unsigned int _count, uint8_t _block) {
+	if(!_count || (isUniform() && m_palette[0] == _block)) return;
+
+	unsigned int newIndex = getPaletteIndex(_block);
+	for(unsigned int i = _index; i < _index + _count; i++){
+		unsigned int oldIndex = readIndex(i);
+		if(oldIndex == newIndex) continue;
+		writeIndex(i, newIndex);
+		m_counts[oldIndex]--;
+		m_counts[newIndex]++;
+	}
+
+	if(m_counts[newIndex] == CHUNK_SIZE) fill(_block);
+}
+
+void BlockStorage::fill(uint8_t _block) {
+	m_palette.assign(1, _block);
+	m_counts.assign(1, CHUNK_SIZE);
+	m_view = nullptr;
+	m_data.reset();
+}
+
+void BlockStorage::load(const uint8_t* _blocks) {
+	// Building the palette first so the index array only gets allocated once
+	uint8_t lookup[256];
+	bool used[256] = {};
+	m_palette.clear();
+	m_counts.clear();
+	for(unsigned int i = 0; i < CHUNK_SIZE; i++){
+		if(!used[_blocks[i]]){
+			used[_blocks[i]] = true;
+			lookup[_blocks[i]] = m_palette.size();
+			m_palette.push_back(_blocks[i]);
+			m_counts.push_back(0);
+		}
+		m_counts[lookup[_blocks[i]]]++;
+	}
+	m_palette.shrink_to_fit();
+	m_counts.shrink_to_fit();
+
+	m_view = nullptr;
+	m_data.reset();
+	int bitsLog2 = getRequiredBitsLog2(m_palette.size());
+	if(bitsLog2 < 0) return;
+	m_bitsLog2 = bitsLog2;
+	m_data = std::make_shared<std::vector<uint64_t>>(getWordCount(), 0);
+	for(unsigned int i = 0; i < CHUNK_SIZE; i++){
+		writeIndex(i, lookup[_blocks[i]]);
+	}
+}
+
+void BlockStorage::unpack(uint8_t* _blocks) const {
+	if(isUniform()){
+		memset(_blocks, m_palette[0], CHUNK_SIZE);
+		return;
+	}
+
+	// Decoding a whole word at a time instead of locating every index on its own
+	const uint64_t* words = getWords();
+	unsigned int bits = 1u << m_bitsLog2;
+	unsigned int indicesPerWord = 64 >> m_bitsLog2;
+	uint64_t mask = (1ull << bits) - 1;
+	for(unsigned int i = 0; i < getWordCount(); i++){
+		uint64_t word = words[i];
+		for(unsigned int j = 0; j < indicesPerWord; j++){
+			*_blocks++ = m_palette[word & mask];
+			word >>= bits;
+		}
+	}
+}
+
+void BlockStorage::serialize(std::vector<uint8_t>& _out) const {
+	unsigned int paletteSize = m_palette.size();
+	unsigned int bits = getBitsPerIndex();
+
+	_out.resize(BLOB_HEADER_SIZE + paletteSize);
+	_out[0] = CODEC_PACKED;
+	_out[1] = bits;
+	_out[2] = paletteSize & 0xFF;
+	_out[3] = paletteSize >> 8;
+	memcpy(&_out[BLOB_HEADER_SIZE], m_palette.data(), paletteSize);
+	if(isUniform()) return;
+
+	// Run length encoding the indices, which wins by a lot on layered terrain
+	std::vector<uint8_t> runs;
+	unsigned int current = readIndex(0);
+	unsigned int length = 0;
+	for(unsigned int i = 0; i <= CHUNK_SIZE; i++){
+		unsigned int index = i < CHUNK_SIZE ? readIndex(i) : current + 1;
+		if(index == current && length < 0xFFFF){
+			length++;
+			continue;
+		}
+		runs.push_back(length & 0xFF);
+		runs.push_back(length >> 8);
+		runs.push_back(current);
+		current = index;
+		length = 1;
+	}
+
+	// The packed words are 8 byte aligned within the blob so they can be read in place
+	unsigned int packedOffset = (_out.size() + 7) & ~7u;
+	unsigned int packedSize = packedOffset + getWordCount() * sizeof(uint64_t);
+	if(_out.size() + runs.size() < packedSize){
+		_out[0] = CODEC_RLE;
+		_out.insert(_out.end(), runs.begin(), runs.end());
+	}else{
+		_out.resize(packedSize, 0);
+		memcpy(&_out[packedOffset], getWords(), getWordCount() * sizeof(uint64_t));
+	}
+}
+
+bool BlockStorage::deserialize(const uint8_t* _data, unsigned int _size, const std::shared_ptr<const void>& _viewOwner) {
+	if(_size < BLOB_HEADER_SIZE) return false;
+	uint8_t codec = _data[0];
+	unsigned int bits = _data[1];
+	unsigned int paletteSize = _data[2] | (_data[3] << 8);
+	if(paletteSize == 0 || paletteSize > 256 || _size < BLOB_HEADER_SIZE + paletteSize) return false;
+
+	int bitsLog2 = -1;
+	for(int i = 0; i < 4; i++){
+		if(bits == (1u << i)) bitsLog2 = i;
+	}
+	if(bits == 0){
+		if(paletteSize != 1) return false;
+	}else if(bitsLog2 < 0 || (1u << bits) < paletteSize){
+		return false;
+	}
+
+	std::vector<uint8_t> palette(_data + BLOB_HEADER_SIZE, _data + BLOB_HEADER_SIZE + paletteSize);
+	std::vector<uint32_t> counts(paletteSize, 0);
+	if(bits == 0){
+		counts[0] = CHUNK_SIZE;
+		m_palette.swap(palette);
+		m_counts.swap(counts);
+		m_view = nullptr;
+		m_data.reset();
+		return true;
+	}
+
+	unsigned int wordCount = (CHUNK_SIZE << bitsLog2) / 64;
+	unsigned int payloadOffset = BLOB_HEADER_SIZE + paletteSize;
+	if(codec == CODEC_PACKED){
+		payloadOffset = (payloadOffset + 7) & ~7u;
+		if(_size < payloadOffset + wordCount * sizeof(uint64_t)) return false;
+		const uint8_t* payload = _data + payloadOffset;
+
+		// Views need the words to be naturally aligned, which region files guarantee but a plain buffer may not
+		std::vector<uint64_t> data;
+		const uint64_t* words = (const uint64_t*)payload;
+		bool view = _viewOwner && ((uintptr_t)payload & 7) == 0;
+		if(!view){
+			data.resize(wordCount);
+			memcpy(data.data(), payload, wordCount * sizeof(uint64_t));
+			words = data.data();
+		}
+
+		// Indices past the palette would read garbage, so a blob referencing them is treated as corrupt
+		for(unsigned int i = 0; i < CHUNK_SIZE; i++){
+			unsigned int index = readPackedIndex(words, bitsLog2, i);
+			if(index >= paletteSize) return false;
+			counts[index]++;
+		}
+		m_data.reset();
+		if(!view) m_data = std::make_shared<std::vector<uint64_t>>(std::move(data));
+		m_view = view ? std::shared_ptr<const uint64_t>(_viewOwner, words) : nullptr;
+		m_bitsLog2 = bitsLog2;
+	}else if(codec == CODEC_RLE){
+		m_view = nullptr;
+		m_data = std::make_shared<std::vector<uint64_t>>(wordCount, 0);
+		m_bitsLog2 = bitsLog2;
+		unsigned int position = 0;
+		for(unsigned int i = payloadOffset; i + 3 <= _size; i += 3){
+			unsigned int length = _data[i] | (_data[i + 1] << 8);
+			unsigned int index = _data[i + 2];
+			if(index >= paletteSize || position + length > CHUNK_SIZE) break;
+			counts[index] += length;
+			for(unsigned int j = 0; j < length; j++){
+				writeIndex(position++, index);
+			}
+		}
+		if(position != CHUNK_SIZE){
+			fill(palette[0]);
+			return false;
+		}
+	}else{
+		return false;
+	}
+	m_palette.swap(palette);
+	m_counts.swap(counts);
+	return true;
+}
+
+unsigned int BlockStorage::getPaletteSize() const {
+	return m_palette.size();
+}
+
+bool BlockStorage::isUniform() const {
+	return !m_view && !m_data;
+}
+
+bool BlockStorage::isView() const {
+	return m_view != nullptr;
+}
+
+unsigned int BlockStorage::getBitsPerIndex() const {
+	if(isUniform()) return 0;
+	return 1u << m_bitsLog2;
+}
+
+unsigned int BlockStorage::getMemoryUsage() const {
+	unsigned int dataSize = m_data ? m_data->capacity() * sizeof(uint64_t) : 0;
+	return sizeof(BlockStorage) + m_palette.capacity() + m_counts.capacity() * sizeof(uint32_t) + dataSize;
+}
+
+unsigned int BlockStorage::getPaletteIndex(uint8_t _block) {
+	auto it = std::find(m_palette.begin(), m_palette.end(), _block);
+	if(it != m_palette.end()) return it - m_palette.begin();
+
+	// Recycling an entry no block uses anymore keeps the palette, and with it the index width, from only ever growing
+	auto unused = std::find(m_counts.begin(), m_counts.end(), 0u);
+	if(unused != m_counts.end()){
+		unsigned int index = unused - m_counts.begin();
+		m_palette[index] = _block;
+		return index;
+	}
+
+	m_palette.push_back(_block);
+	m_counts.push_back(0);
+	int bitsLog2 = getRequiredBitsLog2(m_palette.size());
+	if(isUniform() || bitsLog2 > (int)m_bitsLog2){
+		setBitsPerIndex(bitsLog2);
+	}
+	return m_palette.size() - 1;
+}
+
+void BlockStorage::setBitsPerIndex(unsigned int _bitsLog2) {
+	// Holding on to the old words while repacking, they may be shared with a snapshot or live in a mapped file
+	bool wasUniform = isUniform();
+	std::shared_ptr<std::vector<uint64_t>> oldData = m_data;
+	std::shared_ptr<const uint64_t> oldView = m_view;
+	const uint64_t* oldWords = wasUniform ? nullptr : getWords();
+	unsigned int oldBitsLog2 = m_bitsLog2;
+
+	m_bitsLog2 = _bitsLog2;
+	m_view = nullptr;
+	m_data = std::make_shared<std::vector<uint64_t>>(getWordCount(), 0);
+
+	// A uniform chunk has every index at 0, which the freshly zeroed array already represents
+	if(wasUniform) return;
+	for(unsigned int i = 0; i < CHUNK_SIZE; i++){
+		writeIndex(i, readPackedIndex(oldWords, oldBitsLog2, i));
+	}
+}
+
+unsigned int BlockStorage::readIndex(unsigned int _index) const {
+	return readPackedIndex(getWords(), m_bitsLog2, _index);
+}
+
+void BlockStorage::writeIndex(unsigned int _index, unsigned int _paletteIndex) {
+	makeWritable();
+	unsigned int indicesPerWordLog2 = 6 - m_bitsLog2;
+	uint64_t& word = (*m_data)[_index >> indicesPerWordLog2];
+	unsigned int shift = (_index & ((1u << indicesPerWordLog2) - 1)) << m_bitsLog2;
+	uint64_t mask = ((1ull << (1u << m_bitsLog2)) - 1) << shift;
+	word = (word & ~mask) | ((uint64_t)_paletteIndex << shift);
+}
+
+const uint64_t* BlockStorage::getWords() const {
+	return m_view ? m_view.get() : m_data->data();
+}
+
+unsigned int BlockStorage::getWordCount() const {
+	return (CHUNK_SIZE << m_bitsLog2) / 64;
+}
+
+void BlockStorage::makeWritable() {
+	if(m_view){
+		m_data = std::make_shared<std::vector<uint64_t>>(m_view.get(), m_view.get() + getWordCount());
+		m_view = nullptr;
+	}else if(m_data.use_count() > 1){
+		// Someone else (a snapshot being saved or meshed) still reads these words, so we write to our own copy
+		m_data = std::make_shared<std::vector<uint64_t>>(*m_data);
+	}else{
+		// use_count() is a relaxed load, the fence orders our writes after the last reads of a snapshot released on another thread
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+}
+
+bool BlockStorage::benchmark(const std::vector<uint8_t>& _world){
+	int cw = CHUNK_WIDTH;
+	int maxW = WORLD_WIDTH * cw;
+	int maxL = WORLD_LENGTH * cw;
+	int maxH = WORLD_HEIGHT * cw;
+
+	// Splitting the world into chunks the same way RegionStorage::convertLegacyWorld does
+	std::vector<BlockStorage> chunks(WORLD_WIDTH * WORLD_HEIGHT * WORLD_LENGTH);
+	std::vector<uint8_t> blocks(CHUNK_SIZE);
+	std::vector<uint8_t> unpacked(CHUNK_SIZE);
+	unsigned int memoryUsage = 0;
+	bool isIdentical = true;
+	for(int y = 0; y < WORLD_HEIGHT; y++){
+		for(int z = 0; z < WORLD_LENGTH; z++){
+			for(int x = 0; x < WORLD_WIDTH; x++){
+				for(int j = 0; j < cw; j++){
+					for(int k = 0; k < cw; k++){
+						memcpy(&blocks[(j * cw * cw) + (k * cw)], &_world[((y * cw + j) * maxW * maxL) + ((z * cw + k) * maxW) + x * cw], cw);
+					}
+				}
+				BlockStorage& chunk = chunks[(((y * WORLD_LENGTH) + z) * WORLD_WIDTH) + x];
+				chunk.load(blocks.data());
+				chunk.unpack(unpacked.data());
+				isIdentical &= unpacked == blocks;
+				memoryUsage += chunk.getMemoryUsage();
+			}
+		}
+	}
+	std::cout << "BlockStorage: " << chunks.size() << " chunks use " << memoryUsage / 1024 << " KB, " << _world.size() / 1024 << " KB as a flat array" << std::endl;
+
+	// Random lookups like the ones collisions and raycasts make, the same ones for both layouts
+	const unsigned int NUM_LOOKUPS = 1 << 24;
+	struct Position {
+		uint16_t x, y, z;
+	};
+	std::vector<Position> positions(NUM_LOOKUPS);
+	std::mt19937 random(1337);
+	for(auto& position : positions){
+		position = { (uint16_t)(random() % maxW), (uint16_t)(random() % maxH), (uint16_t)(random() % maxL) };
+	}
+	auto measure = [&](const char* _name, auto _getBlock){
+		auto start = std::chrono::steady_clock::now();
+		uint64_t sum = 0;
+		for(auto& position : positions){
+			sum += _getBlock(position.x, position.y, position.z);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "BlockStorage: " << _name << ": " << (unsigned int)(NUM_LOOKUPS / seconds / 1000000.0) << " M lookups/s" << std::endl;
+		return sum;
+	};
+	uint64_t flatSum = measure("Flat array", [&](int _x, int _y, int _z){
+		return _world[(_y * maxW * maxL) + (_z * maxW) + _x];
+	});
+	uint64_t chunkSum = measure("Chunk storage", [&](int _x, int _y, int _z){
+		const BlockStorage& chunk = chunks[((((_y / cw) * WORLD_LENGTH) + (_z / cw)) * WORLD_WIDTH) + (_x / cw)];
+		return chunk.get(((_y % cw) * cw * cw) + ((_z % cw) * cw) + (_x % cw));
+	});
+
+	if(!isIdentical || flatSum != chunkSum){
+		std::cout << "BlockStorage: The chunk storage doesn't hold the same blocks as the flat array" << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+
+// Stores the blocks of a single chunk as a palette of block IDs plus a bit-packed array of palette indices.
+// Indices are 0, 1, 2, 4 or 8 bits wide so they never straddle two 64 bit words. A chunk made of a single
+// block type uses no index data at all, and a chunk with 2-3 block types only needs 2 bits per block.
+// The packed indices can also be read straight out of a memory mapped region file, in which case they
+// only get copied to the heap the first time the chunk is edited. Copies of a storage share their packed
+// indices until one of them is edited, which makes snapshots for the background saver and the mesh workers cheap.
+// Every palette entry keeps a count of the blocks using it, so unused entries get recycled and a chunk
+// that ends up as a single block type again drops its index data.
+class BlockStorage {
+public:
+
+	BlockStorage();
+
+	uint8_t get(unsigned int _index) const;
+	void set(unsigned int _index, uint8_t _block);
+	// Sets _count consecutive blocks starting at _index, looking up the palette entry only once
+	void setRun(unsigned int _index, unsigned int _count, uint8_t _block);
+	void fill(uint8_t _block);
+
+	// Replaces the whole contents with CHUNK_SIZE blocks laid out as (y * CHUNK_WIDTH * CHUNK_WIDTH) + (z * CHUNK_WIDTH) + x
+	void load(const uint8_t* _blocks);
+	// The reverse of load, writes out all CHUNK_SIZE blocks
+	void unpack(uint8_t* _blocks) const;
+
+	// Serialization used by the region files, see RegionFile.hpp for the layout
+	void serialize(std::vector<uint8_t>& _out) const;
+	// When _viewOwner is set, packed indices are referenced in place instead of copied. _viewOwner owns _data (a mapped file)
+	// and is kept alive by this storage and its copies until they get edited
+	bool deserialize(const uint8_t* _data, unsigned int _size, const std::shared_ptr<const void>& _viewOwner = nullptr);
+
+	bool isUniform() const;
+	bool isView() const;
+	unsigned int getPaletteSize() const;
+	unsigned int getBitsPerIndex() const;
+	unsigned int getMemoryUsage() const; // Heap memory only, mapped pages belong to the OS page cache
+
+	// Prints the memory footprint and random get() throughput of one storage per chunk next to the flat array the world
+	// used to keep, for _world in the layout of RegionStorage::readLegacyWorld. Returns false if the two disagree on a block
+	static bool benchmark(const std::vector<uint8_t>& _world);
+
+private:
+
+	unsigned int getPaletteIndex(uint8_t _block);
+	void setBitsPerIndex(unsigned int _bitsLog2);
+	unsigned int readIndex(unsigned int _index) const;
+	void writeIndex(unsigned int _index, unsigned int _paletteIndex);
+	const uint64_t* getWords() const;
+	unsigned int getWordCount() const;
+	void makeWritable();
+
+	std::vector<uint8_t> m_palette;
+	std::vector<uint32_t> m_counts; // Number of blocks using each palette entry
+	std::shared_ptr<std::vector<uint64_t>> m_data; // Shared between copies until one of them writes
+	std::shared_ptr<const uint64_t> m_view; // Packed indices inside someone else's memory (a mapped file), used instead of m_data when set
+	unsigned int m_bitsLog2 = 0; // log2 of the number of bits per index, only meaningful when the storage isn't uniform
+
+};
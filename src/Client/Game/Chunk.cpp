@@ -1,49 +1,235 @@
 #include "Chunk.hpp"
+#include "TTConfig.hpp"
+#include <cstring>
+
+const unsigned int SECTION_FACE_SLACK = 24; // Spare faces per section, so most edits can be uploaded in place
 
 Chunk::Chunk() {
-	needsMeshUpdate = true;
-	m_vaoID = 0;
-	m_vboID = 0;
+	needsMeshUpdate = false;
 }
 
-void Chunk::init(int _x, int _y, int _z) {
+void Chunk::init(int _x, int _y, int _z, ChunkBuffer* _buffer) {
 	x = _x;
 	y = _y;
 	z = _z;
+	m_buffer = _buffer;
+	m_faceStride = m_buffer->getFaceStride();
+}
 
-	glGenVertexArrays(1, &m_vaoID);
-	glBindVertexArray(m_vaoID);
+void Chunk::pushData() {
+	GLsizeiptr faceSize = sizeof(GLuint) * m_faceStride;
 
-	glGenBuffers(1, &m_vboID);
-	glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
+	// Sections that still fit into their range get updated in place, the rest of the range stays untouched
+	bool fits = true;
+	unsigned int capacity = 0; // Of a compact layout
+	for(auto& section : sections){
+		unsigned int count = section.needsUpload ? countFaces(section.mesh) : countFaces(section);
+		if(count > section.capacity){
+			fits = false;
+		}
+		capacity += count ? count + SECTION_FACE_SLACK : 0;
+	}
 
-	glEnableVertexAttribArray(0);
+	// When the faces after the range are free, the sections that outgrew theirs get moved to the end of the range
+	// and nothing else has to be touched. That leaves their old ranges unused, so it's only done while the range
+	// stays within twice of what a compact layout would take
+	if(!fits){
+		unsigned int extendedCount = m_range.count;
+		for(auto& section : sections){
+			unsigned int count = countFaces(section.mesh);
+			if(section.needsUpload && count > section.capacity){
+				extendedCount += count + SECTION_FACE_SLACK;
+			}
+		}
+		unsigned int end = m_range.count;
+		if(extendedCount <= capacity * 2 && m_buffer->tryExtend(m_range, extendedCount)){
+			for(auto& section : sections){
+				unsigned int count = countFaces(section.mesh);
+				if(section.needsUpload && count > section.capacity){
+					section.first = end;
+					section.capacity = count + SECTION_FACE_SLACK;
+					end += section.capacity;
+				}
+			}
+			fits = true;
+		}
+	}
+	if(fits){
+		glBindBuffer(GL_ARRAY_BUFFER, m_buffer->getBufferID(m_range.arena));
+		for(auto& section : sections){
+			if(section.needsUpload){
+				uploadSection(GL_ARRAY_BUFFER, section);
+			}
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		updateNumFaces();
+		return;
+	}
 
-	glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, 0, 0);
+	// Otherwise the sections get laid out compactly again in a new range, and the ones that didn't change are copied over on the GPU.
+	// The old range is only freed after the copies, so the two ranges can't overlap
+	ChunkBufferRange oldRange = m_range;
+	unsigned int oldFirst[CHUNK_NUM_SECTIONS];
+	capacity = 0;
+	for(unsigned int i = 0; i < CHUNK_NUM_SECTIONS; i++){
+		ChunkSection& section = sections[i];
+		oldFirst[i] = section.first;
+		unsigned int count = section.needsUpload ? countFaces(section.mesh) : countFaces(section);
+		section.first = capacity;
+		section.capacity = count ? count + SECTION_FACE_SLACK : 0;
+		capacity += section.capacity;
+	}
+	m_range = m_buffer->allocate(capacity);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer->getBufferID(m_range.arena));
+	glBindBuffer(GL_COPY_READ_BUFFER, m_buffer->getBufferID(oldRange.arena));
+	for(unsigned int i = 0; i < CHUNK_NUM_SECTIONS; i++){
+		ChunkSection& section = sections[i];
+		if(section.needsUpload){
+			uploadSection(GL_COPY_WRITE_BUFFER, section);
+		} else if(countFaces(section)){
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (oldRange.first + oldFirst[i]) * faceSize, (m_range.first + section.first) * faceSize, countFaces(section) * faceSize);
+		}
+	}
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	m_buffer->free(oldRange);
+	updateNumFaces();
+}
 
+void Chunk::uploadSection(GLenum _target, ChunkSection& _section) {
+	GLsizeiptr faceSize = sizeof(GLuint) * m_faceStride;
+	unsigned int first = m_range.first + _section.first;
+	for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+		std::vector<GLuint>& faces = _section.mesh.faces[pass];
+		_section.counts[pass] = faces.size() / m_faceStride;
+		glBufferSubData(_target, first * faceSize, _section.counts[pass] * faceSize, faces.data());
+		first += _section.counts[pass];
+		std::vector<GLuint>().swap(faces);
+	}
+	_section.needsUpload = false;
 }
 
-void Chunk::pushData() {
-	glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	m_numVertices = vertices.size();
+void Chunk::updateNumFaces() {
+	for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+		m_numFaces[pass] = 0;
+		for(auto& section : sections){
+			m_numFaces[pass] += section.counts[pass];
+		}
+	}
+}
+
+unsigned int Chunk::countFaces(const SectionMesh& _mesh) const {
+	unsigned int count = 0;
+	for(auto& faces : _mesh.faces){
+		count += faces.size() / m_faceStride;
+	}
+	return count;
+}
+
+unsigned int Chunk::countFaces(const ChunkSection& _section) const {
+	unsigned int count = 0;
+	for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+		count += _section.counts[pass];
+	}
+	return count;
+}
+
+uint8_t Chunk::getBlock(unsigned int _x, unsigned int _y, unsigned int _z) const {
+	return blocks.get((_y * CHUNK_WIDTH * CHUNK_WIDTH) + (_z * CHUNK_WIDTH) + _x);
+}
+
+void Chunk::setBlock(unsigned int _x, unsigned int _y, unsigned int _z, uint8_t _block) {
+	blocks.set((_y * CHUNK_WIDTH * CHUNK_WIDTH) + (_z * CHUNK_WIDTH) + _x, _block);
+
+	uint8_t& height = heightmap[(_z * CHUNK_WIDTH) + _x];
+	if(_block){
+		if(_y + 1 > height) height = _y + 1;
+	}else if(_y + 1 == height){
+		// The top block got removed, so we look for the next one down
+		height = 0;
+		for(int y = (int)_y - 1; y >= 0; y--){
+			if(getBlock(_x, y, _z)){
+				height = y + 1;
+				break;
+			}
+		}
+	}
+}
+
+void Chunk::updateHeightmap() {
+	unsigned int cw = CHUNK_WIDTH;
+
+	if(blocks.isUniform()){
+		memset(heightmap, blocks.get(0) ? cw : 0, sizeof(heightmap));
+		return;
+	}
+
+	// Going down layer by layer keeps the reads in storage order, and we can stop once every column has its top
+	memset(heightmap, 0, sizeof(heightmap));
+	unsigned int columnsLeft = cw * cw;
+	for(int y = cw - 1; y >= 0 && columnsLeft; y--){
+		for(unsigned int z = 0; z < cw; z++){
+			for(unsigned int x = 0; x < cw; x++){
+				uint8_t& height = heightmap[(z * cw) + x];
+				if(!height && getBlock(x, y, z)){
+					height = y + 1;
+					columnsLeft--;
+				}
+			}
+		}
+	}
+}
+
+uint8_t Chunk::getHeight(unsigned int _x, unsigned int _z) const {
+	return heightmap[(_z * CHUNK_WIDTH) + _x];
+}
+
+unsigned int Chunk::getNumFaces() const {
+	unsigned int count = 0;
+	for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+		count += m_numFaces[pass];
+	}
+	return count;
+}
+
+unsigned int Chunk::getNumFaces(unsigned int _pass) const {
+	return m_numFaces[_pass];
+}
+
+unsigned int Chunk::getMeshMemoryUsage() const {
+	return m_range.count * m_faceStride * sizeof(GLuint);
 }
 
-unsigned int Chunk::getNumVertices(){
-	return m_numVertices;
+const ChunkBufferRange& Chunk::getBufferRange() const {
+	return m_range;
 }
 
-void Chunk::render() {
-	glBindVertexArray(m_vaoID);
-	glDrawArrays(GL_TRIANGLES, 0, m_numVertices);
+void Chunk::render(unsigned int _pass) {
+	glBindVertexArray(m_buffer->getVaoID(m_range.arena));
+	glBindBuffer(GL_ARRAY_BUFFER, m_buffer->getBufferID(m_range.arena));
+
+	// GL 3.3 can't start a draw at a later instance, so the attributes get pointed at the range of every section instead
+	GLsizei stride = sizeof(GLuint) * m_faceStride;
+	for(auto& section : sections){
+		unsigned int first = m_range.first + section.first;
+		for(unsigned int pass = 0; pass < _pass; pass++){
+			first += section.counts[pass];
+		}
+		unsigned int count = section.counts[_pass];
+		if(!count) continue;
+		size_t offset = first * stride;
+		glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, stride, (void*)offset);
+		if(m_faceStride > 1){
+			glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, stride, (void*)(offset + sizeof(GLuint)));
+		}
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 }
 
 void Chunk::destroy() {
-	glDeleteVertexArrays(1, & m_vaoID);
-	glDeleteBuffers(1, & m_vboID);
+	m_buffer->free(m_range);
 }
@@ -3,34 +3,87 @@
 #include <vector>
 #include <cstddef>
 #include "Vertex.hpp"
+#include "BlockStorage.hpp"
+#include "TTConfig.hpp"
+#include "ChunkMesher.hpp"
+#include "ChunkBuffer.hpp"
+#include "ChunkVisibility.hpp"
 #include <iostream>
 
+// A cube of CHUNK_SECTION_WIDTH blocks that gets meshed and uploaded on its own, every section has a range in the chunk's range of faces
+struct ChunkSection {
+	SectionMesh mesh; // Only kept until it's uploaded
+	uint64_t meshID = 0; // Request the mesh came from, see MeshRequest
+	bool needsUpload = false;
+	// In faces from the start of the chunk's range, the passes are stored one after another from first on
+	unsigned int first = 0;
+	unsigned int counts[NUM_CHUNK_PASSES] = {};
+	unsigned int capacity = 0;
+};
+
 class Chunk {
 public:
 
 	Chunk();
-	void init(int _x, int _y, int _z);
+	// The faces go into a range of _buffer, which also decides whether there's a size after every face, see ChunkMesher
+	void init(int _x, int _y, int _z, ChunkBuffer* _buffer);
 
 	// Utility functions
-	void render();
+	// Draws the faces of one pass, see CHUNK_PASS_OPAQUE. With multi draw the MultiDrawRenderer draws them instead
+	void render(unsigned int _pass);
+	// Uploads the sections that need it
 	void pushData();
-	unsigned int getNumVertices();
+	unsigned int getNumFaces() const;
+	unsigned int getNumFaces(unsigned int _pass) const;
+	unsigned int getMeshMemoryUsage() const; // Bytes of the chunk's range
+	const ChunkBufferRange& getBufferRange() const;
 	void destroy();
 
+	// Block access in chunk space
+	uint8_t getBlock(unsigned int _x, unsigned int _y, unsigned int _z) const;
+	void setBlock(unsigned int _x, unsigned int _y, unsigned int _z, uint8_t _block);
+
+	// Rebuilds the heightmap from scratch, setBlock keeps it up to date afterwards
+	void updateHeightmap();
+	// Height of the topmost non-air block in the column plus one, 0 if the column is all air
+	uint8_t getHeight(unsigned int _x, unsigned int _z) const;
+
 	// Public variables
 	int x = 0;
 	int y = 0;
 	int z = 0;
-	std::vector<GLuint> vertices;
-	bool needsMeshUpdate = true;
-	bool needsVaoUpdate = false;
+	ChunkSection sections[CHUNK_NUM_SECTIONS];
+	BlockStorage blocks;
+	uint32_t version = 0; // Incremented on every edit of the blocks
+	bool needsMeshUpdate = false; // Set while the chunk is queued for meshing
+	uint64_t dirtySections = 0; // Mask of the sections that need meshing, see ChunkMesher
+	bool isMeshUrgent = false; // Set when the queued remesh comes from a player edit
+	double playerEditTime = -1.0; // World time of the oldest player edit that isn't visible yet, negative if there's none
+	uint64_t playerEditMeshID = 0; // First mesh request that includes that edit, 0 until it got requested
+	uint64_t playerEditSections = 0; // The sections of that request
+	bool needsVaoUpdate = false; // Set while the new mesh is waiting to be uploaded
+	bool needsSave = false; // Set when the blocks differ from what's stored in the region file
+	uint8_t heightmap[CHUNK_WIDTH * CHUNK_WIDTH] = {}; // Indexed as (z * CHUNK_WIDTH) + x, see getHeight
+	// Pairs of faces that can see each other through the chunk, see ChunkVisibility. Everything is connected until the
+	// first mesh is done, so a chunk never hides the ones behind it before it knows
+	uint16_t visibility = ALL_CHUNK_FACES_CONNECTED;
+	uint64_t visibilityMeshID = 0; // Request the visibility came from
+	// Occlusion culling state of the current render, see World::render
+	bool isInFrustum = false;
+	uint8_t enteredFaces = 0; // Faces the walk from the camera came into the chunk through, one bit per face
 
 private:
 
+	void uploadSection(GLenum _target, ChunkSection& _section);
+	void updateNumFaces();
+	unsigned int countFaces(const SectionMesh& _mesh) const;
+	unsigned int countFaces(const ChunkSection& _section) const; // What's uploaded
+
 	// Opengl Variables
-	GLuint m_vaoID = 0;
-	GLuint m_vboID = 0;
-	GLuint m_numVertices = 0;
+	ChunkBuffer* m_buffer = nullptr;
+	ChunkBufferRange m_range;
+	GLuint m_numFaces[NUM_CHUNK_PASSES] = {};
+	unsigned int m_faceStride = 1; // GLuints per face
 
 };
 
@@ -0,0 +1,186 @@
+#include "ChunkBuffer.hpp"
+#include <algorithm>
+#include <iterator>
+
+float ChunkBufferStats::getUtilisation() const {
+	return capacity ? (float)allocated / capacity : 0.0f;
+}
+
+float ChunkBufferStats::getFragmentation() const {
+	unsigned int free = capacity - allocated;
+	return free ? 1.0f - ((float)largestFreeRange / free) : 0.0f;
+}
+
+void ChunkBuffer::init(unsigned int _faceStride, unsigned int _arenaCapacity){
+	m_faceStride = _faceStride;
+	m_arenaCapacity = _arenaCapacity;
+	createArena(m_arenaCapacity);
+}
+
+void ChunkBuffer::destroy(){
+	for(auto& arena : m_arenas){
+		deleteArena(arena);
+	}
+	m_arenas.clear();
+}
+
+ChunkBufferRange ChunkBuffer::allocate(unsigned int _count){
+	ChunkBufferRange range;
+	if(!_count){
+		return range;
+	}
+
+	unsigned int arenaIndex = 0;
+	auto it = m_arenas[0].freeRanges.end();
+	for(; arenaIndex < m_arenas.size(); arenaIndex++){
+		auto& freeRanges = m_arenas[arenaIndex].freeRanges;
+		it = std::find_if(freeRanges.begin(), freeRanges.end(), [&](auto& freeRange){ return freeRange.second >= _count; });
+		if(it != freeRanges.end()){
+			break;
+		}
+	}
+	if(arenaIndex == m_arenas.size()){
+		// Meshes larger than an arena get an arena of their own
+		arenaIndex = createArena(std::max(m_arenaCapacity, _count));
+		it = m_arenas[arenaIndex].freeRanges.begin();
+	}
+
+	Arena& arena = m_arenas[arenaIndex];
+	range.arena = arenaIndex;
+	range.first = it->first;
+	range.count = _count;
+	unsigned int remaining = it->second - _count;
+	arena.freeRanges.erase(it);
+	if(remaining){
+		arena.freeRanges[range.first + _count] = remaining;
+	}
+	arena.allocated += _count;
+	arena.numRanges++;
+	return range;
+}
+
+bool ChunkBuffer::tryExtend(ChunkBufferRange& _range, unsigned int _count){
+	if(!_range.count || _count <= _range.count){
+		return false;
+	}
+	Arena& arena = m_arenas[_range.arena];
+	auto next = arena.freeRanges.find(_range.first + _range.count);
+	unsigned int extra = _count - _range.count;
+	if(next == arena.freeRanges.end() || next->second < extra){
+		return false;
+	}
+
+	unsigned int remaining = next->second - extra;
+	arena.freeRanges.erase(next);
+	if(remaining){
+		arena.freeRanges[_range.first + _count] = remaining;
+	}
+	arena.allocated += extra;
+	_range.count = _count;
+	return true;
+}
+
+void ChunkBuffer::free(ChunkBufferRange& _range){
+	if(!_range.count){
+		return;
+	}
+	Arena& arena = m_arenas[_range.arena];
+	arena.allocated -= _range.count;
+	arena.numRanges--;
+
+	// Merging with the free ranges right before and after it
+	unsigned int first = _range.first;
+	unsigned int count = _range.count;
+	auto next = arena.freeRanges.lower_bound(first);
+	if(next != arena.freeRanges.begin()){
+		auto previous = std::prev(next);
+		if(previous->first + previous->second == first){
+			first = previous->first;
+			count += previous->second;
+			arena.freeRanges.erase(previous);
+		}
+	}
+	if(next != arena.freeRanges.end() && first + count == next->first){
+		count += next->second;
+		arena.freeRanges.erase(next);
+	}
+	arena.freeRanges[first] = count;
+	_range = ChunkBufferRange();
+
+	if(!arena.allocated && &arena != &m_arenas[0]){
+		deleteArena(arena);
+	}
+}
+
+unsigned int ChunkBuffer::createArena(unsigned int _capacity){
+	// Slots of deleted arenas get reused, so the arena indices of the chunks stay valid
+	unsigned int index = 0;
+	while(index < m_arenas.size() && m_arenas[index].bufferID){
+		index++;
+	}
+	if(index == m_arenas.size()){
+		m_arenas.emplace_back();
+	}
+	Arena& arena = m_arenas[index];
+
+	glGenBuffers(1, &arena.bufferID);
+	glBindBuffer(GL_ARRAY_BUFFER, arena.bufferID);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)_capacity * m_faceStride * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Every face is one instance, the vertex shader builds the 6 vertices of its quad
+	glGenVertexArrays(1, &arena.vaoID);
+	glBindVertexArray(arena.vaoID);
+	glEnableVertexAttribArray(0);
+	glVertexAttribDivisor(0, 1);
+	if(m_faceStride > 1){
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+	}
+	glBindVertexArray(0);
+
+	arena.capacity = _capacity;
+	arena.allocated = 0;
+	arena.numRanges = 0;
+	arena.freeRanges.clear();
+	arena.freeRanges[0] = _capacity;
+	return index;
+}
+
+void ChunkBuffer::deleteArena(Arena& _arena){
+	glDeleteBuffers(1, &_arena.bufferID);
+	glDeleteVertexArrays(1, &_arena.vaoID);
+	_arena = Arena();
+}
+
+GLuint ChunkBuffer::getBufferID(unsigned int _arena) const {
+	return m_arenas[_arena].bufferID;
+}
+
+GLuint ChunkBuffer::getVaoID(unsigned int _arena) const {
+	return m_arenas[_arena].vaoID;
+}
+
+unsigned int ChunkBuffer::getNumArenas() const {
+	return m_arenas.size();
+}
+
+unsigned int ChunkBuffer::getFaceStride() const {
+	return m_faceStride;
+}
+
+ChunkBufferStats ChunkBuffer::getStats() const {
+	ChunkBufferStats stats;
+	for(auto& arena : m_arenas){
+		if(!arena.bufferID) continue;
+		stats.numArenas++;
+		stats.capacity += arena.capacity;
+		stats.allocated += arena.allocated;
+		stats.numRanges += arena.numRanges;
+		stats.numFreeRanges += arena.freeRanges.size();
+		for(auto& freeRange : arena.freeRanges){
+			stats.largestFreeRange = std::max(stats.largestFreeRange, freeRange.second);
+		}
+	}
+	return stats;
+}
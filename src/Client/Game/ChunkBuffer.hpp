@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GLAD/glad.h>
+#include <map>
+#include <vector>
+
+// Faces a chunk got from the ChunkBuffer, count is 0 while it has none
+struct ChunkBufferRange {
+	unsigned int arena = 0;
+	unsigned int first = 0; // In faces from the start of the arena
+	unsigned int count = 0;
+};
+
+// Totals over every arena, all in faces except numArenas
+struct ChunkBufferStats {
+	unsigned int numArenas = 0;
+	unsigned int capacity = 0;
+	unsigned int allocated = 0;
+	unsigned int numRanges = 0; // Handed out and not freed yet
+	unsigned int numFreeRanges = 0;
+	unsigned int largestFreeRange = 0;
+
+	// Share of the arenas that is handed out
+	float getUtilisation() const;
+	// Share of the free faces that can't be used for a range as large as the largest free one,
+	// 0 when all of them are in one range and close to 1 when they are scattered in small holes
+	float getFragmentation() const;
+};
+
+// Holds the meshes of every chunk in a few large GL buffers, the arenas, so remeshing a chunk doesn't make the driver
+// allocate new storage. Chunks get ranges of faces out of an arena and update them in place as long as the mesh
+// fits. The free ranges of an arena are kept sorted by their first face and neighbouring ones are merged again.
+// A new arena is only created when none of the others has a free range that's big enough, and an arena that
+// becomes empty gets deleted again, except for the first one
+class ChunkBuffer {
+public:
+
+	// _faceStride is in GLuints per face, _arenaCapacity in faces
+	void init(unsigned int _faceStride, unsigned int _arenaCapacity);
+	void destroy();
+
+	// First fit over the arenas in the order they were created, so the meshes stay packed into the first ones
+	ChunkBufferRange allocate(unsigned int _count);
+	// Grows the range to _count faces without moving it, only works when the faces right after it are free
+	bool tryExtend(ChunkBufferRange& _range, unsigned int _count);
+	void free(ChunkBufferRange& _range);
+
+	// Every arena has a VAO with the instanced face attributes enabled, their pointers are set by whoever draws
+	GLuint getBufferID(unsigned int _arena) const;
+	GLuint getVaoID(unsigned int _arena) const;
+	unsigned int getNumArenas() const; // Including the slots of deleted arenas, which have a buffer ID of 0
+	unsigned int getFaceStride() const;
+	ChunkBufferStats getStats() const;
+
+private:
+
+	struct Arena {
+		GLuint bufferID = 0;
+		GLuint vaoID = 0;
+		unsigned int capacity = 0;
+		unsigned int allocated = 0;
+		unsigned int numRanges = 0;
+		std::map<unsigned int, unsigned int> freeRanges; // First face to number of faces
+	};
+
+	unsigned int createArena(unsigned int _capacity);
+	void deleteArena(Arena& _arena);
+
+	std::vector<Arena> m_arenas;
+	unsigned int m_faceStride = 1;
+	unsigned int m_arenaCapacity = 0;
+
+};
@@ -0,0 +1,54 @@
+#include "ChunkChangeFeed.hpp"
+#include <algorithm>
+
+const uint64_t NO_SUBSCRIBER = UINT64_MAX;
+
+unsigned int ChunkChangeFeed::subscribe(){
+	uint64_t end = m_firstSequence + m_changes.size();
+
+	// Reusing the slot of an old subscriber keeps the ids small
+	for(unsigned int i = 0; i < m_cursors.size(); i++){
+		if(m_cursors[i] == NO_SUBSCRIBER){
+			m_cursors[i] = end;
+			return i;
+		}
+	}
+	m_cursors.push_back(end);
+	return m_cursors.size() - 1;
+}
+
+void ChunkChangeFeed::unsubscribe(unsigned int _subscriber){
+	m_cursors[_subscriber] = NO_SUBSCRIBER;
+	trim();
+}
+
+void ChunkChangeFeed::publish(const ChunkChange& _change){
+	// Nobody would ever read it
+	if(std::all_of(m_cursors.begin(), m_cursors.end(), [](uint64_t _cursor){ return _cursor == NO_SUBSCRIBER; })){
+		m_firstSequence++;
+		return;
+	}
+	m_changes.push_back(_change);
+}
+
+void ChunkChangeFeed::poll(unsigned int _subscriber, std::vector<ChunkChange>& _changes){
+	uint64_t& cursor = m_cursors[_subscriber];
+	_changes.insert(_changes.end(), m_changes.begin() + (cursor - m_firstSequence), m_changes.end());
+	cursor = m_firstSequence + m_changes.size();
+	trim();
+}
+
+unsigned int ChunkChangeFeed::getNumBuffered() const {
+	return m_changes.size();
+}
+
+void ChunkChangeFeed::trim(){
+	uint64_t oldest = m_firstSequence + m_changes.size();
+	for(uint64_t cursor : m_cursors){
+		oldest = std::min(oldest, cursor);
+	}
+	while(m_firstSequence < oldest){
+		m_changes.pop_front();
+		m_firstSequence++;
+	}
+}
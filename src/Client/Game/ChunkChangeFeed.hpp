@@ -0,0 +1,59 @@
+#pragma once
+
+#include "TTConfig.hpp"
+#include <glm/glm.hpp>
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+enum class ChunkChangeType : uint8_t {
+	LOADED,
+	EDITED,
+	UNLOADED
+};
+
+// Faces of a chunk, an edit lists the ones it touched so consumers know which neighbours can see the change
+const uint8_t CHUNK_BORDER_LEFT = 1 << 0; // -x
+const uint8_t CHUNK_BORDER_RIGHT = 1 << 1; // +x
+const uint8_t CHUNK_BORDER_BOTTOM = 1 << 2; // -y
+const uint8_t CHUNK_BORDER_TOP = 1 << 3; // +y
+const uint8_t CHUNK_BORDER_BACK = 1 << 4; // -z
+const uint8_t CHUNK_BORDER_FRONT = 1 << 5; // +z
+const uint8_t CHUNK_BORDER_ALL = 0x3F;
+
+struct ChunkChange {
+	glm::ivec3 position; // In chunk coordinates
+	uint32_t version = 0; // The chunk's version right after the change
+	ChunkChangeType type = ChunkChangeType::EDITED;
+	uint8_t borders = 0; // CHUNK_BORDER_* bits, only set for edits
+	// Inclusive box of the blocks that changed, in chunk space. Loads and unloads cover the whole chunk
+	glm::ivec3 min = glm::ivec3(0);
+	glm::ivec3 max = glm::ivec3(CHUNK_WIDTH - 1);
+	bool isPlayerEdit = false; // Edits the player made directly, consumers should handle them first
+};
+
+// An append-only log of chunk changes that any number of subscribers read at their own pace.
+// Every subscriber has a cursor into the log, and changes get dropped once every subscriber has read them.
+// Only used from the main thread.
+class ChunkChangeFeed {
+public:
+
+	// New subscribers only see changes published after they subscribed
+	unsigned int subscribe();
+	void unsubscribe(unsigned int _subscriber);
+
+	void publish(const ChunkChange& _change);
+	// Appends every change published since the subscriber's last poll to _changes, oldest first
+	void poll(unsigned int _subscriber, std::vector<ChunkChange>& _changes);
+
+	unsigned int getNumBuffered() const;
+
+private:
+
+	void trim();
+
+	std::deque<ChunkChange> m_changes;
+	uint64_t m_firstSequence = 0; // Sequence number of the change at the front of m_changes
+	std::vector<uint64_t> m_cursors; // Sequence number of the next change each subscriber reads, UINT64_MAX for unused slots
+
+};
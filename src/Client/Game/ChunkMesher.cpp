@@ -0,0 +1,433 @@
+#include "ChunkMesher.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+// Offsets to the neighbouring blocks in the padded buffer
+const int DX = 1;
+const int DY = PADDED_CHUNK_WIDTH * PADDED_CHUNK_WIDTH;
+const int DZ = PADDED_CHUNK_WIDTH;
+
+// Everything the mesher needs to know about the 6 face directions.
+// The AO values of a face get stored in winding order, quadCorners lists the corners in that order as u + (v * 2),
+// the chunk vertex shader has the matching corner positions
+struct FaceDirection {
+	unsigned int normalAxis; // 0 = x, 1 = y, 2 = z
+	int normalSign;
+	unsigned int uAxis;
+	unsigned int vAxis;
+	uint8_t quadCorners[4];
+};
+
+constexpr FaceDirection FACE_DIRECTIONS[6] = {
+	{ 1, 1, 0, 2, { 0, 2, 3, 1 } },
+	{ 1, -1, 0, 2, { 0, 1, 3, 2 } },
+	{ 0, -1, 2, 1, { 0, 1, 3, 2 } },
+	{ 0, 1, 2, 1, { 0, 2, 3, 1 } },
+	{ 2, -1, 0, 1, { 0, 2, 3, 1 } },
+	{ 2, 1, 0, 1, { 0, 1, 3, 2 } }
+};
+
+constexpr int AXIS_OFFSETS[3] = { DX, DY, DZ };
+
+// Offsets to the 9 blocks in the layer in front of a face, which make up its 9 bit occupancy mask. Bits 0 to 7 walk
+// around the face in winding order: bit 2k is the block diagonal to corner k and bit 2k + 1 the block between corner k
+// and corner k + 1, so every corner finds its sides and its diagonal at the same bits whatever the direction.
+// Bit 8 is the block right in front of the face
+struct FaceNeighbours {
+	int offsets[9];
+};
+
+constexpr std::array<FaceNeighbours, 6> makeFaceNeighbours(){
+	std::array<FaceNeighbours, 6> neighbours = {};
+	for(unsigned int face = 0; face < 6; face++){
+		const FaceDirection& direction = FACE_DIRECTIONS[face];
+		int normal = direction.normalSign * AXIS_OFFSETS[direction.normalAxis];
+		int u = AXIS_OFFSETS[direction.uAxis];
+		int v = AXIS_OFFSETS[direction.vAxis];
+		for(unsigned int k = 0; k < 4; k++){
+			uint8_t corner = direction.quadCorners[k];
+			uint8_t next = direction.quadCorners[(k + 1) % 4];
+			int du = corner & 1 ? u : -u;
+			int dv = corner & 2 ? v : -v;
+			neighbours[face].offsets[k * 2] = normal + du + dv;
+			// Neighbouring corners share either their u or their v side
+			neighbours[face].offsets[(k * 2) + 1] = normal + ((corner & 1) == (next & 1) ? du : dv);
+		}
+		neighbours[face].offsets[8] = normal;
+	}
+	return neighbours;
+}
+
+constexpr std::array<FaceNeighbours, 6> FACE_NEIGHBOURS = makeFaceNeighbours();
+
+// Indexed by the occupancy mask of FaceNeighbours, gives the AO of the 4 corners in winding order packed
+// the way they go into a face (2 bits each). A face that is covered by a see-through block gets 2 everywhere
+constexpr std::array<uint8_t, 512> makeAOTable(){
+	std::array<uint8_t, 512> table = {};
+	for(unsigned int mask = 0; mask < 512; mask++){
+		uint8_t ao = 0;
+		for(unsigned int k = 0; k < 4; k++){
+			unsigned int side1 = (mask >> ((k * 2) + 1)) & 1;
+			unsigned int side2 = (mask >> ((k * 2) + 7) % 8) & 1;
+			unsigned int corner = (mask >> (k * 2)) & 1;
+			unsigned int value;
+			if(mask & 256) value = 2;
+			else if(side1 && side2) value = 0;
+			else value = 3 - (side1 + side2 + corner);
+			ao |= value << (k * 2);
+		}
+		table[mask] = ao;
+	}
+	return table;
+}
+
+constexpr std::array<uint8_t, 512> AO_TABLE = makeAOTable();
+
+// Every corner of the face has the same AO value
+bool isUniformAO(uint8_t _ao){
+	return _ao == (_ao & 3) * 0x55;
+}
+
+// Loading the neighbours is all that's left per face, the AO rules are in AO_TABLE
+uint8_t calcFaceAO(unsigned int _face, const uint8_t* _block){
+	const int* offsets = FACE_NEIGHBOURS[_face].offsets;
+	unsigned int mask = 0;
+	for(unsigned int i = 0; i < 9; i++){
+		mask |= (unsigned int)(_block[offsets[i]] != 0) << i;
+	}
+	return AO_TABLE[mask];
+}
+
+const uint64_t ROW_MASK = (1ull << PADDED_CHUNK_WIDTH) - 1;
+
+// Byte masks for testing 8 blocks at once
+const uint64_t LOW_BITS = 0x7F7F7F7F7F7F7F7Full;
+const uint64_t HIGH_BITS = 0x8080808080808080ull;
+const uint64_t ONE_PER_BYTE = 0x0101010101010101ull;
+
+// One bit per byte of _bytes that isn't zero, the first byte in memory goes to the lowest bit
+uint8_t getNonZeroBytes(uint64_t _bytes){
+	uint64_t high = (((_bytes & LOW_BITS) + LOW_BITS) | _bytes) & HIGH_BITS;
+	// The multiplication moves the high bit of every byte next to each other in the top byte
+	return ((high >> 7) * 0x0102040810204080ull) >> 56;
+}
+
+void ChunkMesher::init(bool _greedy){
+	m_isGreedy = _greedy;
+	m_faceMask.resize(CHUNK_SECTION_WIDTH * CHUNK_SECTION_WIDTH);
+	m_solidBits.resize(PADDED_CHUNK_SIZE / 64 + 2);
+	m_opaqueBits.resize(PADDED_CHUNK_SIZE / 64 + 2);
+	m_solidRows.resize(PADDED_CHUNK_WIDTH * PADDED_CHUNK_WIDTH);
+	m_opaqueRows.resize(PADDED_CHUNK_WIDTH * PADDED_CHUNK_WIDTH);
+}
+
+bool ChunkMesher::isGreedy() const {
+	return m_isGreedy;
+}
+
+void ChunkMesher::generateMesh(const uint8_t* _blocks, uint64_t _sections, SectionMesh* _meshes){
+	int sw = CHUNK_SECTION_WIDTH;
+	int spa = CHUNK_SECTIONS_PER_AXIS;
+
+	// The row masks are shared by all sections, so they get built once for every layer any of them reads
+	if(!m_isGreedy){
+		int min[3];
+		int max[3];
+		getSectionBounds(_sections, min, max);
+		buildRowMasks(_blocks, min[1], max[1]);
+	}
+	while(_sections){
+		unsigned int section = std::countr_zero(_sections);
+		_sections &= _sections - 1;
+		int origin[3] = { (int)(section % spa) * sw, (int)(section / (spa * spa)) * sw, (int)((section / spa) % spa) * sw };
+
+		m_mesh = &_meshes[section];
+		for(auto& faces : m_mesh->faces){
+			faces.resize(0);
+		}
+		if(m_isGreedy){
+			generateGreedyMesh(_blocks, origin);
+		} else {
+			generateSectionMesh(_blocks, origin);
+		}
+	}
+	m_mesh = nullptr;
+}
+
+void ChunkMesher::generateMeshByLookup(const std::function<uint8_t(int, int, int)>& _getBlock, uint64_t _sections, SectionMesh* _meshes){
+	int sw = CHUNK_SECTION_WIDTH;
+	int spa = CHUNK_SECTIONS_PER_AXIS;
+	m_lookupBlocks.resize(PADDED_CHUNK_SIZE);
+
+	while(_sections){
+		unsigned int section = std::countr_zero(_sections);
+		_sections &= _sections - 1;
+		int origin[3] = { (int)(section % spa) * sw, (int)(section / (spa * spa)) * sw, (int)((section / spa) % spa) * sw };
+
+		m_mesh = &_meshes[section];
+		for(auto& faces : m_mesh->faces){
+			faces.resize(0);
+		}
+		for(int y = origin[1]; y < origin[1] + sw; y++){
+			for(int z = origin[2]; z < origin[2] + sw; z++){
+				for(int x = origin[0]; x < origin[0] + sw; x++){
+					uint8_t* block = &m_lookupBlocks[getPaddedIndex(x, y, z)];
+					*block = _getBlock(x, y, z);
+					if(!*block) continue;
+
+					// Like before, a block that's hidden on every side only costs the 6 lookups in front of its faces
+					block[DY] = _getBlock(x, y + 1, z);
+					block[-DY] = _getBlock(x, y - 1, z);
+					block[DX] = _getBlock(x + 1, y, z);
+					block[-DX] = _getBlock(x - 1, y, z);
+					block[DZ] = _getBlock(x, y, z + 1);
+					block[-DZ] = _getBlock(x, y, z - 1);
+					if(!isBlockTransparent(block[DY]) && !isBlockTransparent(block[-DY]) && !isBlockTransparent(block[DX])
+						&& !isBlockTransparent(block[-DX]) && !isBlockTransparent(block[DZ]) && !isBlockTransparent(block[-DZ])){
+						continue;
+					}
+
+					// The AO of the visible faces needs the rest of the blocks around it
+					for(int dy = -1; dy <= 1; dy++){
+						for(int dz = -1; dz <= 1; dz++){
+							for(int dx = -1; dx <= 1; dx++){
+								if((dx != 0) + (dy != 0) + (dz != 0) > 1){
+									block[(dy * DY) + (dz * DZ) + (dx * DX)] = _getBlock(x + dx, y + dy, z + dz);
+								}
+							}
+						}
+					}
+					addBlock(block, x, y, z);
+				}
+			}
+		}
+	}
+	m_mesh = nullptr;
+}
+
+unsigned int ChunkMesher::getSectionIndex(int _x, int _y, int _z){
+	int sw = CHUNK_SECTION_WIDTH;
+	int spa = CHUNK_SECTIONS_PER_AXIS;
+	return ((_y / sw) * spa * spa) + ((_z / sw) * spa) + (_x / sw);
+}
+
+void ChunkMesher::getSectionBounds(uint64_t _sections, int* _min, int* _max){
+	int sw = CHUNK_SECTION_WIDTH;
+	int spa = CHUNK_SECTIONS_PER_AXIS;
+	for(int axis = 0; axis < 3; axis++){
+		_min[axis] = CHUNK_WIDTH;
+		_max[axis] = -1;
+	}
+	while(_sections){
+		unsigned int section = std::countr_zero(_sections);
+		_sections &= _sections - 1;
+		int origin[3] = { (int)(section % spa) * sw, (int)(section / (spa * spa)) * sw, (int)((section / spa) % spa) * sw };
+		for(int axis = 0; axis < 3; axis++){
+			_min[axis] = std::min(_min[axis], origin[axis] - 1);
+			_max[axis] = std::max(_max[axis], origin[axis] + sw);
+		}
+	}
+}
+
+uint64_t ChunkMesher::getSectionMask(const int* _low, const int* _high){
+	int sw = CHUNK_SECTION_WIDTH;
+	uint64_t mask = 0;
+	for(int y = _low[1] / sw; y <= _high[1] / sw; y++){
+		for(int z = _low[2] / sw; z <= _high[2] / sw; z++){
+			for(int x = _low[0] / sw; x <= _high[0] / sw; x++){
+				mask |= 1ull << getSectionIndex(x * sw, y * sw, z * sw);
+			}
+		}
+	}
+	return mask;
+}
+
+void ChunkMesher::generateSectionMesh(const uint8_t* _blocks, const int* _origin){
+	int sw = CHUNK_SECTION_WIDTH;
+
+	// A face is visible when its block is solid and the neighbour in front of it isn't opaque, so with every row
+	// packed into bit masks the faces of a whole row come out of a few shifts and ANDs
+	int rw = PADDED_CHUNK_WIDTH;
+	uint64_t sectionMask = ((1ull << sw) - 1) << (_origin[0] + 1);
+	for(int y = _origin[1]; y < _origin[1] + sw; y++){
+		for(int z = _origin[2]; z < _origin[2] + sw; z++){
+			unsigned int row = ((y + 1) * rw) + (z + 1);
+			uint64_t solid = m_solidRows[row];
+			uint64_t opaque = m_opaqueRows[row];
+			uint64_t top = solid & ~m_opaqueRows[row + rw];
+			uint64_t bottom = solid & ~m_opaqueRows[row - rw];
+			uint64_t left = solid & ~(opaque >> 1);
+			uint64_t right = solid & ~(opaque << 1);
+			uint64_t front = solid & ~m_opaqueRows[row - 1];
+			uint64_t back = solid & ~m_opaqueRows[row + 1];
+
+			// Only blocks with at least one visible face get visited, in the same order and with the same face order as addBlock
+			uint64_t visible = (top | bottom | left | right | front | back) & sectionMask;
+			const uint8_t* rowStart = &_blocks[getPaddedIndex(-1, y, z)];
+			while(visible){
+				unsigned int bit = std::countr_zero(visible);
+				visible &= visible - 1;
+				uint64_t blockBit = 1ull << bit;
+				const uint8_t* block = rowStart + bit;
+				uint8_t x = bit - 1;
+
+				if(top & blockBit) addFace(FACE_TOP, block, x, y, z);
+				if(bottom & blockBit) addFace(FACE_BOTTOM, block, x, y, z);
+				if(left & blockBit) addFace(FACE_LEFT, block, x, y, z);
+				if(right & blockBit) addFace(FACE_RIGHT, block, x, y, z);
+				if(front & blockBit) addFace(FACE_FRONT, block, x, y, z);
+				if(back & blockBit) addFace(FACE_BACK, block, x, y, z);
+			}
+		}
+	}
+}
+
+void ChunkMesher::buildRowMasks(const uint8_t* _blocks, int _minY, int _maxY){
+	int rw = PADDED_CHUNK_WIDTH;
+	int firstRow = (_minY + 1) * rw;
+	int endRow = (_maxY + 2) * rw;
+
+	// First the layers get turned into two flat bit sets, 8 blocks at a time.
+	// Loading the bytes with memcpy puts the first block in the lowest byte on little endian machines
+	std::fill(m_solidBits.begin(), m_solidBits.end(), 0);
+	std::fill(m_opaqueBits.begin(), m_opaqueBits.end(), 0);
+	int end = std::min((endRow * rw + 7) / 8, PADDED_CHUNK_SIZE / 8);
+	for(int i = (firstRow * rw) / 8; i < end; i++){
+		uint64_t bytes;
+		memcpy(&bytes, &_blocks[i * 8], sizeof(bytes));
+		uint64_t solid = getNonZeroBytes(bytes);
+		uint64_t opaque = solid;
+		for(uint8_t seeThrough : SEE_THROUGH_BLOCKS){
+			opaque &= getNonZeroBytes(bytes ^ (seeThrough * ONE_PER_BYTE));
+		}
+		m_solidBits[i / 8] |= solid << ((i % 8) * 8);
+		m_opaqueBits[i / 8] |= opaque << ((i % 8) * 8);
+	}
+
+	// Then every row gets cut out of them, bit x + 1 of a row stands for the block at x, the border blocks included
+	for(int row = firstRow; row < endRow; row++){
+		unsigned int bit = row * rw;
+		unsigned int word = bit / 64;
+		unsigned int shift = bit % 64;
+		uint64_t solid = m_solidBits[word] >> shift;
+		uint64_t opaque = m_opaqueBits[word] >> shift;
+		if(shift + rw > 64){
+			solid |= m_solidBits[word + 1] << (64 - shift);
+			opaque |= m_opaqueBits[word + 1] << (64 - shift);
+		}
+		m_solidRows[row] = solid & ROW_MASK;
+		m_opaqueRows[row] = opaque & ROW_MASK;
+	}
+}
+
+unsigned int ChunkMesher::getPaddedIndex(int _x, int _y, int _z){
+	return ((_y + 1) * DY) + ((_z + 1) * DZ) + (_x + 1);
+}
+
+void ChunkMesher::generateGreedyMesh(const uint8_t* _blocks, const int* _origin){
+	int sw = CHUNK_SECTION_WIDTH;
+
+	for(unsigned int face = 0; face < 6; face++){
+		const FaceDirection& direction = FACE_DIRECTIONS[face];
+		int normal = direction.normalSign * AXIS_OFFSETS[direction.normalAxis];
+
+		for(int slice = _origin[direction.normalAxis]; slice < _origin[direction.normalAxis] + sw; slice++){
+			// Building a mask of the faces in this slice, faces that can't be merged are added right away
+			for(int j = 0; j < sw; j++){
+				for(int i = 0; i < sw; i++){
+					int position[3];
+					position[direction.normalAxis] = slice;
+					position[direction.uAxis] = _origin[direction.uAxis] + i;
+					position[direction.vAxis] = _origin[direction.vAxis] + j;
+					const uint8_t* block = &_blocks[getPaddedIndex(position[0], position[1], position[2])];
+					uint32_t& mask = m_faceMask[(j * sw) + i];
+					mask = 0;
+
+					if(!*block || !isBlockTransparent(block[normal])) continue;
+
+					const BlockInfo& info = getBlockInfo(*block);
+					uint16_t textureLayer = info.textures[face];
+					unsigned int pass = info.flags & BLOCK_FLAG_CUTOUT ? CHUNK_PASS_CUTOUT : CHUNK_PASS_OPAQUE;
+
+					// Interpolating AO across a merged quad would smear it, so only faces with the same AO at all 4 corners get merged
+					uint8_t ao = calcFaceAO(face, block);
+					if(!isUniformAO(ao)){
+						std::vector<GLuint>& faces = m_mesh->faces[pass];
+						faces.push_back(packFace(position[0], position[1], position[2], face, ao, textureLayer));
+						faces.push_back(packFaceSize(1, 1, 1));
+						continue;
+					}
+					mask = (textureLayer + 1) | ((ao & 3) << 16) | (pass << 18);
+				}
+			}
+
+			// Growing every face along u first and then along v as long as the whole row matches
+			for(int j = 0; j < sw; j++){
+				for(int i = 0; i < sw; ){
+					uint32_t mask = m_faceMask[(j * sw) + i];
+					if(!mask){
+						i++;
+						continue;
+					}
+					int width = 1;
+					while(i + width < sw && m_faceMask[(j * sw) + i + width] == mask){
+						width++;
+					}
+					int height = 1;
+					while(j + height < sw){
+						bool rowMatches = true;
+						for(int k = 0; k < width && rowMatches; k++){
+							rowMatches = m_faceMask[((j + height) * sw) + i + k] == mask;
+						}
+						if(!rowMatches) break;
+						height++;
+					}
+					for(int l = 0; l < height; l++){
+						for(int k = 0; k < width; k++){
+							m_faceMask[((j + l) * sw) + i + k] = 0;
+						}
+					}
+
+					int position[3];
+					int extent[3];
+					position[direction.normalAxis] = slice;
+					position[direction.uAxis] = _origin[direction.uAxis] + i;
+					position[direction.vAxis] = _origin[direction.vAxis] + j;
+					extent[direction.normalAxis] = 1;
+					extent[direction.uAxis] = width;
+					extent[direction.vAxis] = height;
+					uint16_t textureLayer = (mask & 0xFFFF) - 1;
+					unsigned int ao = (mask >> 16) & 3;
+					std::vector<GLuint>& faces = m_mesh->faces[mask >> 18];
+					faces.push_back(packFace(position[0], position[1], position[2], face, ao * 0x55, textureLayer));
+					faces.push_back(packFaceSize(extent[0], extent[1], extent[2]));
+					i += width;
+				}
+			}
+		}
+	}
+}
+
+void ChunkMesher::addFace(unsigned int _face, const uint8_t* _block, uint8_t _x, uint8_t _y, uint8_t _z){
+	uint8_t textureLayer = getBlockInfo(*_block).textures[_face];
+	m_mesh->faces[getBlockPass(*_block)].push_back(packFace(_x, _y, _z, _face, calcFaceAO(_face, _block), textureLayer));
+}
+
+void ChunkMesher::addBlock(const uint8_t* _block, uint8_t _x, uint8_t _y, uint8_t _z){
+	if(isBlockTransparent(_block[DY])) addFace(FACE_TOP, _block, _x, _y, _z);
+	if(isBlockTransparent(_block[-DY])) addFace(FACE_BOTTOM, _block, _x, _y, _z);
+	if(isBlockTransparent(_block[DX])) addFace(FACE_LEFT, _block, _x, _y, _z);
+	if(isBlockTransparent(_block[-DX])) addFace(FACE_RIGHT, _block, _x, _y, _z);
+	if(isBlockTransparent(_block[-DZ])) addFace(FACE_FRONT, _block, _x, _y, _z);
+	if(isBlockTransparent(_block[DZ])) addFace(FACE_BACK, _block, _x, _y, _z);
+}
+
+GLuint ChunkMesher::packFace(uint8_t _x, uint8_t _y, uint8_t _z, unsigned int _face, uint8_t _ao, uint16_t _textureLayer){
+	return _x | _y << 5 | _z << 10 | _face << 15 | (GLuint)_ao << 18 | (GLuint)_textureLayer << 26;
+}
+
+GLuint ChunkMesher::packFaceSize(unsigned int _x, unsigned int _y, unsigned int _z){
+	return _x | _y << 6 | _z << 12;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "BlockRegistry.hpp"
+#include "TTConfig.hpp"
+#include <GLAD/glad.h>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+// A chunk plus a one block border on every side
+const int PADDED_CHUNK_WIDTH = CHUNK_WIDTH + 2;
+const int PADDED_CHUNK_SIZE = PADDED_CHUNK_WIDTH * PADDED_CHUNK_WIDTH * PADDED_CHUNK_WIDTH;
+
+// Sections of a chunk are passed around as bit masks, bit i standing for section i, see getSectionIndex
+static_assert(CHUNK_WIDTH % CHUNK_SECTION_WIDTH == 0, "Sections have to tile the chunk");
+static_assert(CHUNK_NUM_SECTIONS <= 64, "Section masks are 64 bits");
+const uint64_t ALL_CHUNK_SECTIONS = CHUNK_NUM_SECTIONS == 64 ? ~0ull : (1ull << CHUNK_NUM_SECTIONS) - 1;
+
+// Chunks get drawn in passes with separate meshes, so only the cutout pass has to discard fragments
+// and the opaque pass keeps early depth testing
+const unsigned int CHUNK_PASS_OPAQUE = 0;
+const unsigned int CHUNK_PASS_CUTOUT = 1; // Blocks with see-through holes in their texture, like leaves
+const unsigned int NUM_CHUNK_PASSES = 2;
+
+inline unsigned int getBlockPass(uint8_t _blockID){
+	return getBlockInfo(_blockID).flags & BLOCK_FLAG_CUTOUT ? CHUNK_PASS_CUTOUT : CHUNK_PASS_OPAQUE;
+}
+
+// The faces of one section, one list per pass
+struct SectionMesh {
+	std::vector<GLuint> faces[NUM_CHUNK_PASSES];
+};
+
+// Builds chunk meshes out of a padded copy of the chunk that includes the border blocks of its neighbours.
+// With the border in the same buffer every neighbour of a block sits at a fixed offset from it, so meshing
+// never has to bounds check a lookup or go through the world to find the chunk a neighbour is in.
+// Face culling works on bit masks of whole rows along x, so blocks with no visible face are skipped 32 at a time.
+//
+// Meshes are made of one GLuint per face, drawn as one instance of 6 vertices each. From the lowest bit up:
+// x, y and z of the block (5 bits each), the face direction (3 bits), the AO of the 4 corners in winding
+// order (2 bits each) and the texture layer (6 bits). The chunk vertex shader expands them into the quads.
+//
+// The greedy mesher merges neighbouring faces that share a direction, a texture and a uniform AO value into
+// larger quads. Every face is then followed by a second GLuint with the size of the quad along x, y and z
+// (6 bits each). Textures repeat once per block across merged quads.
+//
+// Every section of CHUNK_SECTION_WIDTH blocks gets its own mesh, so an edit only has to remesh the sections
+// around it. Positions stay in chunk space and quads never cross a section border.
+class ChunkMesher {
+public:
+
+	void init(bool _greedy = false);
+	bool isGreedy() const;
+	// _blocks holds PADDED_CHUNK_SIZE blocks laid out as in getPaddedIndex. Every section in the _sections mask
+	// gets meshed into _meshes[section], _meshes has to hold CHUNK_NUM_SECTIONS meshes
+	void generateMesh(const uint8_t* _blocks, uint64_t _sections, SectionMesh* _meshes);
+	// Meshes the way the world did before the padded buffer and the row masks, one block at a time with every block looked up
+	// through _getBlock, which gets chunk space coordinates from -1 to CHUNK_WIDTH. Only kept as the baseline for benchmarks,
+	// generateMesh has to give exactly the same faces in the same order
+	void generateMeshByLookup(const std::function<uint8_t(int, int, int)>& _getBlock, uint64_t _sections, SectionMesh* _meshes);
+
+	// _x, _y and _z are in chunk space and go from -1 to CHUNK_WIDTH
+	static unsigned int getPaddedIndex(int _x, int _y, int _z);
+	// _x, _y and _z are in chunk space, sections are laid out like blocks, y first and x last
+	static unsigned int getSectionIndex(int _x, int _y, int _z);
+	// Inclusive box of the blocks meshing the sections reads, in chunk space and with the border
+	static void getSectionBounds(uint64_t _sections, int* _min, int* _max);
+	// Mask of the sections overlapping an inclusive box in chunk space
+	static uint64_t getSectionMask(const int* _low, const int* _high);
+
+private:
+
+	// Only the layers from _minY to _maxY get built, the border ones included
+	void buildRowMasks(const uint8_t* _blocks, int _minY, int _maxY);
+	// _origin is the lowest block of the section in chunk space
+	void generateSectionMesh(const uint8_t* _blocks, const int* _origin);
+	void generateGreedyMesh(const uint8_t* _blocks, const int* _origin);
+	// Doesn't check if the face is visible, that's up to the caller. The face goes into the pass of its block
+	void addFace(unsigned int _face, const uint8_t* _block, uint8_t _x, uint8_t _y, uint8_t _z);
+	// Checks all 6 neighbours itself, only used by generateMeshByLookup
+	void addBlock(const uint8_t* _block, uint8_t _x, uint8_t _y, uint8_t _z);
+	// _ao holds the AO of the 4 corners in winding order, 2 bits each
+	GLuint packFace(uint8_t _x, uint8_t _y, uint8_t _z, unsigned int _face, uint8_t _ao, uint16_t _textureLayer);
+	GLuint packFaceSize(unsigned int _x, unsigned int _y, unsigned int _z);
+
+	SectionMesh* m_mesh = nullptr; // The mesh currently being generated
+	bool m_isGreedy = false;
+	std::vector<uint32_t> m_faceMask; // Faces of the section slice being merged by the greedy mesher, 0 for no face
+	std::vector<uint8_t> m_lookupBlocks; // Padded buffer generateMeshByLookup copies the neighbours of one block at a time into
+	// One bit per block of the padded buffer, in the same order
+	std::vector<uint64_t> m_solidBits;
+	std::vector<uint64_t> m_opaqueBits;
+	// One mask per row along x of the padded buffer, indexed by ((y + 1) * PADDED_CHUNK_WIDTH) + (z + 1)
+	std::vector<uint64_t> m_solidRows; // Blocks that aren't air
+	std::vector<uint64_t> m_opaqueRows; // Blocks that hide the faces behind them
+
+};
@@ -0,0 +1,109 @@
+#include "ChunkVisibility.hpp"
+#include <array>
+
+// Bit of every pair of different faces in the visibility mask
+constexpr std::array<std::array<uint8_t, 6>, 6> makePairBits(){
+	std::array<std::array<uint8_t, 6>, 6> bits = {};
+	uint8_t bit = 0;
+	for(unsigned int a = 0; a < 6; a++){
+		for(unsigned int b = a + 1; b < 6; b++){
+			bits[a][b] = bit;
+			bits[b][a] = bit;
+			bit++;
+		}
+	}
+	return bits;
+}
+
+constexpr std::array<std::array<uint8_t, 6>, 6> PAIR_BITS = makePairBits();
+
+// Indexed by a mask of the faces a group of connected blocks touches, gives the pairs it connects
+constexpr std::array<uint16_t, 64> makeFaceMaskVisibility(){
+	std::array<uint16_t, 64> visibility = {};
+	for(unsigned int mask = 0; mask < 64; mask++){
+		for(unsigned int a = 0; a < 6; a++){
+			for(unsigned int b = a + 1; b < 6; b++){
+				if((mask >> a) & (mask >> b) & 1){
+					visibility[mask] |= 1 << PAIR_BITS[a][b];
+				}
+			}
+		}
+	}
+	return visibility;
+}
+
+constexpr std::array<uint16_t, 64> FACE_MASK_VISIBILITY = makeFaceMaskVisibility();
+
+static_assert(CHUNK_WIDTH <= 64, "Rows of blocks are 64 bit masks");
+
+uint16_t ChunkVisibility::compute(const uint8_t* _blocks){
+	int cw = CHUNK_WIDTH;
+	uint64_t fullRow = cw == 64 ? ~0ull : (1ull << cw) - 1;
+	uint64_t borderColumns = 1ull | (1ull << (cw - 1));
+
+	// The flood fill works on whole rows along x at a time, with a bit for every block that doesn't hide what's behind it
+	m_openRows.assign(cw * cw, 0);
+	m_visitedRows.assign(cw * cw, 0);
+	for(int row = 0; row < cw * cw; row++){
+		const uint8_t* blocks = &_blocks[row * cw];
+		uint64_t open = 0;
+		for(int x = 0; x < cw; x++){
+			open |= (uint64_t)isBlockTransparent(blocks[x]) << x;
+		}
+		m_openRows[row] = open;
+	}
+
+	// Groups of blocks that don't reach the border can't connect anything, so the flood fills only start from border blocks.
+	// Rows are indexed as (y * CHUNK_WIDTH) + z
+	uint16_t visibility = 0;
+	for(int row = 0; row < cw * cw; row++){
+		int y = row / cw;
+		int z = row % cw;
+		bool isBorderRow = y == 0 || y == cw - 1 || z == 0 || z == cw - 1;
+		uint64_t starts = m_openRows[row] & (isBorderRow ? fullRow : borderColumns);
+		while(uint64_t unvisited = starts & ~m_visitedRows[row]){
+			// Every flood fill starts from a single block, two blocks of the same row don't have to be connected
+			unsigned int faces = 0;
+			m_stack.push_back({ (uint16_t)row, unvisited & (~unvisited + 1) });
+			while(!m_stack.empty()){
+				RowSpan span = m_stack.back();
+				m_stack.pop_back();
+				uint64_t open = m_openRows[span.row] & ~m_visitedRows[span.row];
+				uint64_t bits = span.bits & open;
+				if(!bits) continue;
+
+				// Spreading along the row first, as far as the open blocks go
+				uint64_t spread;
+				while((spread = (bits | (bits << 1) | (bits >> 1)) & open) != bits){
+					bits = spread;
+				}
+				m_visitedRows[span.row] |= bits;
+
+				int spanY = span.row / cw;
+				int spanZ = span.row % cw;
+				if(bits & 1) faces |= 1 << FACE_RIGHT;
+				if(bits & (1ull << (cw - 1))) faces |= 1 << FACE_LEFT;
+				if(spanY == 0) faces |= 1 << FACE_BOTTOM;
+				if(spanY == cw - 1) faces |= 1 << FACE_TOP;
+				if(spanZ == 0) faces |= 1 << FACE_FRONT;
+				if(spanZ == cw - 1) faces |= 1 << FACE_BACK;
+
+				// Then to the blocks right next to the span in the 4 neighbouring rows
+				if(spanY > 0) m_stack.push_back({ (uint16_t)(span.row - cw), bits });
+				if(spanY < cw - 1) m_stack.push_back({ (uint16_t)(span.row + cw), bits });
+				if(spanZ > 0) m_stack.push_back({ (uint16_t)(span.row - 1), bits });
+				if(spanZ < cw - 1) m_stack.push_back({ (uint16_t)(span.row + 1), bits });
+			}
+
+			visibility |= FACE_MASK_VISIBILITY[faces];
+			if(visibility == ALL_CHUNK_FACES_CONNECTED){
+				return visibility;
+			}
+		}
+	}
+	return visibility;
+}
+
+bool ChunkVisibility::isConnected(uint16_t _visibility, unsigned int _from, unsigned int _to){
+	return _from == _to || ((_visibility >> PAIR_BITS[_from][_to]) & 1);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "BlockRegistry.hpp"
+#include "TTConfig.hpp"
+#include <vector>
+#include <cstdint>
+
+// One bit for every pair of different faces of a chunk, see ChunkVisibility
+const uint16_t ALL_CHUNK_FACES_CONNECTED = (1 << 15) - 1;
+
+// Finds out which faces of a chunk can see each other through it, for occlusion culling between chunks.
+// Two faces are connected when a path of blocks that don't hide what's behind them, like air or leaves, goes from
+// one to the other. Looking into the chunk through one face can only show what's behind the faces connected to it,
+// so World::render walks from the camera chunk through its neighbours along those connections and everything it
+// doesn't reach is hidden behind solid terrain.
+// Every worker of the MeshGenerator has its own, since the flood fill keeps its scratch buffers between chunks
+class ChunkVisibility {
+public:
+
+	// _blocks holds the CHUNK_SIZE blocks of the chunk in storage order, (y * CHUNK_WIDTH * CHUNK_WIDTH) + (z * CHUNK_WIDTH) + x
+	uint16_t compute(const uint8_t* _blocks);
+
+	// The faces are the FACE_ directions, a face is always connected to itself
+	static bool isConnected(uint16_t _visibility, unsigned int _from, unsigned int _to);
+
+private:
+
+	// Blocks of a row along x that were reached, but whose neighbours weren't looked at yet
+	struct RowSpan {
+		uint16_t row;
+		uint64_t bits;
+	};
+
+	// One mask per row along x, indexed by (y * CHUNK_WIDTH) + z
+	std::vector<uint64_t> m_openRows; // Blocks that don't hide what's behind them
+	std::vector<uint64_t> m_visitedRows;
+	std::vector<RowSpan> m_stack;
+
+};
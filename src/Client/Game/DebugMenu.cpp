@@ -1,6 +1,6 @@
 #include "DebugMenu.hpp"
 
-void DebugMenu::render(const FrameCounter& _frameCounter, const Player& _player){
+void DebugMenu::render(const FrameCounter& _frameCounter, const Player& _player, const World& _world){
 	// Drawing FPS
 	GUIRenderer::drawText("FPS: " + std::to_string(_frameCounter.getFrameRate()), glm::vec2(10, 700), glm::vec2(0.5f, 0.5f), ColorRGBA8());
 
@@ -9,4 +9,24 @@ void DebugMenu::render(const FrameCounter& _frameCounter, const Player& _player)
 	GUIRenderer::drawText("X: " + std::to_string(coords.x), glm::vec2(10, 675), glm::vec2(0.5, 0.5), ColorRGBA8());
 	GUIRenderer::drawText("Y: " + std::to_string(coords.y), glm::vec2(10, 650), glm::vec2(0.5, 0.5), ColorRGBA8());
 	GUIRenderer::drawText("Z: " + std::to_string(coords.z), glm::vec2(10, 625), glm::vec2(0.5, 0.5), ColorRGBA8());
+
+	// Drawing block storage memory usage
+	GUIRenderer::drawText("Blocks: " + std::to_string(_world.getBlockMemoryUsage() / 1024) + " KB", glm::vec2(10, 600), glm::vec2(0.5, 0.5), ColorRGBA8());
+	std::string culling = std::to_string(_world.getNumChunksDrawn()) + " drawn, " + std::to_string(_world.getNumChunksCulled()) + " culled, " + std::to_string(_world.getNumChunksOccluded()) + " occluded";
+	GUIRenderer::drawText("Chunks: " + std::to_string(_world.getNumLoadedChunks()) + " (" + culling + ")", glm::vec2(10, 575), glm::vec2(0.5, 0.5), ColorRGBA8());
+
+	// Drawing mesh statistics, to compare the greedy mesher against the naive one and the packed faces against 6 vertices per face
+	unsigned int numFaces = _world.getNumFaces();
+	std::string vertexMemory = std::to_string(numFaces * 6 * sizeof(GLuint) / 1024);
+	GUIRenderer::drawText("Faces: " + std::to_string(numFaces) + " (" + std::to_string(_world.getMeshMemoryUsage() / 1024) + " KB, " + vertexMemory + " KB as vertices)", glm::vec2(10, 550), glm::vec2(0.5, 0.5), ColorRGBA8());
+	std::string mesher = _world.isGreedyMeshing() ? "Greedy" : "Naive";
+	GUIRenderer::drawText(mesher + " mesh: " + std::to_string(_world.getAverageMeshTime()) + " ms, " + std::to_string(_world.getNumMeshesPending()) + " pending", glm::vec2(10, 525), glm::vec2(0.5, 0.5), ColorRGBA8());
+	GUIRenderer::drawText("Edit latency: " + std::to_string(_world.getLastEditLatency()) + " ms (avg " + std::to_string(_world.getAverageEditLatency()) + " ms)", glm::vec2(10, 500), glm::vec2(0.5, 0.5), ColorRGBA8());
+	std::string renderer = _world.isMultiDrawing() ? "Multi draw" : "Per chunk draw";
+	GUIRenderer::drawText(renderer + ": " + std::to_string(_world.getLastDrawTime()) + " ms", glm::vec2(10, 475), glm::vec2(0.5, 0.5), ColorRGBA8());
+
+	// Drawing how full the mesh arenas are, to tune their size
+	ChunkBufferStats stats = _world.getMeshBufferStats();
+	std::string arenas = std::to_string(stats.numArenas) + " arenas, " + std::to_string((int)(stats.getUtilisation() * 100.0f)) + "% used, ";
+	GUIRenderer::drawText("Mesh " + arenas + std::to_string((int)(stats.getFragmentation() * 100.0f)) + "% fragmented", glm::vec2(10, 450), glm::vec2(0.5, 0.5), ColorRGBA8());
 }
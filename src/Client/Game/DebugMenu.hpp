@@ -8,6 +8,6 @@
 class DebugMenu {
 public:
 
-	void render(const FrameCounter& _frameCounter, const Player& _player);
+	void render(const FrameCounter& _frameCounter, const Player& _player, const World& _world);
 
 };
\ No newline at end of file
@@ -5,6 +5,8 @@
 void EntityHandler::init() {
 	m_entityModel.init(FilePathManager::getRootFolderDirectory() + "res/models/monkey.obj");
 	m_shader.load("entity");
+	m_modelUniform = m_shader.getUniform<glm::mat4>("model");
+	m_isBlueTeamUniform = m_shader.getUniform<bool>("isBlueTeam");
 }
 
 void EntityHandler::update(float _deltaTime) {
@@ -35,14 +37,11 @@ void EntityHandler::updateEntity(uint8_t id, const glm::vec3& position, float pi
 	}
 }
 
-void EntityHandler::render(Camera& camera) {
+void EntityHandler::render() {
 	m_shader.bind();
-	m_shader.loadUniform("view", camera.getViewMatrix());
-	m_shader.loadUniform("projection", camera.getProjectionMatrix());
-	m_shader.loadUniform("camPos", camera.getPosition());
 	for(auto it = m_entities.begin(); it != m_entities.end(); it++){
-		m_shader.loadUniform("isBlueTeam", it->second.isBlueTeam());
-		m_shader.loadUniform("model", it->second.transform.getMatrix());
+		m_shader.loadUniform(m_isBlueTeamUniform, it->second.isBlueTeam());
+		m_shader.loadUniform(m_modelUniform, it->second.transform.getMatrix());
 		m_entityModel.render(); // Change to actual model
 	}
 	m_shader.unbind();
@@ -15,7 +15,7 @@ public:
 
 	void init();
 	void update(float _deltaTime);
-	void render(Camera& camera);
+	void render();
 	void destroy();
 
 	void updateEntity(uint8_t id, const glm::vec3& position, float pitch, float yaw);
@@ -31,5 +31,7 @@ private:
 
 	Model m_entityModel;
 	Shader m_shader;
+	Uniform<glm::mat4> m_modelUniform;
+	Uniform<bool> m_isBlueTeamUniform;
 
 };
@@ -8,13 +8,13 @@ void Game::init(NetworkManager* _nManager, Settings* _settings, GameStates* _sta
 	m_networkManager = _nManager;
 	m_state = _state;
 
-	m_blockTextureHandler.loadBlockTexturesFromFile();
 	m_textureArray.init(FilePathManager::getRootFolderDirectory() + "res/textures/sprite_sheet.png", 512);
-	m_world.init(&m_textureArray, &m_blockTextureHandler);
+	m_world.init(&m_textureArray, m_settings);
 	player.init(&m_camera, &m_particleHandler, &m_world, _nManager);
 	m_skybox.init();
-	m_particleHandler.init(&m_textureArray, &m_blockTextureHandler);
+	m_particleHandler.init(&m_textureArray);
 	m_camera.init();
+	m_cameraUniforms.init();
 	m_vignette.init();
 	m_entityHandler.init();
 	m_blockOutline.init();
@@ -25,7 +25,8 @@ void Game::init(NetworkManager* _nManager, Settings* _settings, GameStates* _sta
 void Game::updateEssentials(float _deltaTime){
 	m_frameCounter.tick(_deltaTime);
 	m_entityHandler.update(_deltaTime);
-	m_world.updateMeshes();
+	m_world.update(player.getEyePos());
+	m_world.updateMeshes(m_camera);
 	m_camera.setPosition(player.getEyePos());
 	m_particleHandler.update(_deltaTime);
 	networkPositionTick();
@@ -50,15 +51,16 @@ void Game::networkPositionTick(){
 }
 
 void Game::render() {
-	// Rendering gameplay
-	m_skybox.render(m_camera.getProjectionMatrix(), m_camera.getViewMatrix());
+	// Rendering gameplay, every shader gets the camera from the same uniform buffer
+	m_cameraUniforms.update(m_camera);
+	m_skybox.render();
 	m_world.render(m_camera);
-	m_blockOutline.render(&player, m_camera, m_settings->legacyOutline);
-	m_particleHandler.render(m_camera);
-	m_entityHandler.render(m_camera);
+	m_blockOutline.render(&player, m_settings->legacyOutline);
+	m_particleHandler.render();
+	m_entityHandler.render();
 	if(m_settings->isVignetteToggled) m_vignette.render();
 	m_hud.render();
-	if(m_settings->isDebugToggled) m_debugMenu.render(m_frameCounter, player);
+	if(m_settings->isDebugToggled) m_debugMenu.render(m_frameCounter, player, m_world);
 }
 
 void Game::destroy() {
@@ -69,4 +71,5 @@ void Game::destroy() {
 	m_skybox.destroy();
 	m_particleHandler.destroy();
 	m_blockOutline.destroy();
+	m_cameraUniforms.destroy();
 }
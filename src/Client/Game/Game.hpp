@@ -9,6 +9,7 @@
 #include "ParticleHandler.hpp"
 #include "GameStates.hpp"
 #include "Camera.hpp"
+#include "CameraUniforms.hpp"
 #include "BlockOutline.hpp"
 #include "Vignette.hpp"
 #include "Settings.hpp"
@@ -39,6 +40,7 @@ private:
 
 	//Engine Variables
 	Camera m_camera;
+	CameraUniforms m_cameraUniforms;
 	FrameCounter m_frameCounter;
 	Skybox m_skybox;
 	ParticleHandler m_particleHandler;	
@@ -49,7 +51,6 @@ private:
 	World m_world;
 	DebugMenu m_debugMenu;
 	Clock m_dataFrequencyTimer;
-	BlockTextureHandler m_blockTextureHandler;
 	TextureArray m_textureArray;
 
 	// Pointers
@@ -0,0 +1,334 @@
+#include "MeshGenerator.hpp"
+#include "TTConfig.hpp"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <random>
+#include <bit>
+
+void MeshGenerator::init(bool _greedy, unsigned int _numThreads){
+	m_isGreedy = _greedy;
+	if(!_numThreads){
+		unsigned int cores = std::thread::hardware_concurrency();
+		_numThreads = cores > 1 ? cores - 1 : 1;
+	}
+
+	m_isRunning = true;
+	for(unsigned int i = 0; i < _numThreads; i++){
+		m_threads.emplace_back(&MeshGenerator::run, this);
+	}
+}
+
+void MeshGenerator::destroy(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+		m_requests.clear();
+	}
+	m_requestCondition.notify_all();
+	for(auto& thread : m_threads){
+		thread.join();
+	}
+	m_threads.clear();
+	m_finished.clear();
+}
+
+void MeshGenerator::request(MeshRequest&& _request){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(std::move(_request));
+	}
+	m_requestCondition.notify_one();
+}
+
+void MeshGenerator::collect(std::vector<MeshResult>& _results){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	_results.clear();
+	_results.swap(m_finished);
+}
+
+unsigned int MeshGenerator::getNumPending() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_requests.size() + m_numBusy + m_finished.size();
+}
+
+double MeshGenerator::getAverageMeshTime() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(!m_numMeshesGenerated) return 0.0;
+	return m_totalMeshTime * 1000.0 / m_numMeshesGenerated;
+}
+
+unsigned int MeshGenerator::getNumThreads() const {
+	return m_threads.size();
+}
+
+void MeshGenerator::fillPaddedBlocks(const BlockStorage* _blocks, uint64_t _sections, uint8_t* _unpacked, uint8_t* _padded){
+	int cw = CHUNK_WIDTH;
+
+	// Only the blocks the mesher reads for these sections get filled in, the rest of the buffer is left as it was
+	int boundsMin[3];
+	int boundsMax[3];
+	ChunkMesher::getSectionBounds(_sections, boundsMin, boundsMax);
+
+	// The chunk itself gets unpacked in one go and copied into the middle of the buffer row by row
+	_blocks[13].unpack(_unpacked);
+	for(int y = std::max(boundsMin[1], 0); y <= std::min(boundsMax[1], cw - 1); y++){
+		for(int z = std::max(boundsMin[2], 0); z <= std::min(boundsMax[2], cw - 1); z++){
+			memcpy(&_padded[ChunkMesher::getPaddedIndex(0, y, z)], &_unpacked[(y * cw * cw) + (z * cw)], cw);
+		}
+	}
+
+	// Along every axis the border is either the last layer of the previous chunk, the chunk's own range, or the first layer of the next chunk
+	for(int dy = -1; dy <= 1; dy++){
+		for(int dz = -1; dz <= 1; dz++){
+			for(int dx = -1; dx <= 1; dx++){
+				if(!dx && !dy && !dz){
+					continue;
+				}
+				const BlockStorage& neighbour = _blocks[((dy + 1) * 9) + ((dz + 1) * 3) + (dx + 1)];
+				int minX = std::max(dx < 0 ? -1 : (dx > 0 ? cw : 0), boundsMin[0]);
+				int minY = std::max(dy < 0 ? -1 : (dy > 0 ? cw : 0), boundsMin[1]);
+				int minZ = std::max(dz < 0 ? -1 : (dz > 0 ? cw : 0), boundsMin[2]);
+				int maxX = std::min(dx ? (dx < 0 ? -1 : cw) : cw - 1, boundsMax[0]);
+				int maxY = std::min(dy ? (dy < 0 ? -1 : cw) : cw - 1, boundsMax[1]);
+				int maxZ = std::min(dz ? (dz < 0 ? -1 : cw) : cw - 1, boundsMax[2]);
+				for(int y = minY; y <= maxY; y++){
+					for(int z = minZ; z <= maxZ; z++){
+						for(int x = minX; x <= maxX; x++){
+							int index = ((y - dy * cw) * cw * cw) + ((z - dz * cw) * cw) + (x - dx * cw);
+							_padded[ChunkMesher::getPaddedIndex(x, y, z)] = neighbour.get(index);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void MeshGenerator::run(){
+	ChunkMesher mesher;
+	mesher.init(m_isGreedy);
+	ChunkVisibility visibility;
+	std::vector<uint8_t> padded(PADDED_CHUNK_SIZE);
+	std::vector<uint8_t> unpacked(CHUNK_SIZE);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(true){
+		m_requestCondition.wait(lock, [this](){ return !m_requests.empty() || !m_isRunning; });
+		if(!m_isRunning) break;
+
+		MeshRequest request = std::move(m_requests.front());
+		m_requests.pop_front();
+		m_numBusy++;
+		lock.unlock();
+
+		auto start = std::chrono::steady_clock::now();
+		MeshResult result;
+		result.position = request.position;
+		result.id = request.id;
+		result.sections = request.sections;
+		fillPaddedBlocks(request.blocks, request.sections, unpacked.data(), padded.data());
+		mesher.generateMesh(padded.data(), request.sections, result.meshes);
+		result.visibility = visibility.compute(unpacked.data());
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		// The snapshot has to be released before the game thread can see the result, so it can edit those blocks without copying them
+		request = MeshRequest();
+
+		lock.lock();
+		m_finished.push_back(std::move(result));
+		m_numBusy--;
+		m_totalMeshTime += seconds;
+		m_numMeshesGenerated++;
+	}
+}
+
+bool MeshGenerator::benchmark(const std::vector<uint8_t>& _world){
+	int cw = CHUNK_WIDTH;
+	int ww = WORLD_WIDTH;
+	int wl = WORLD_LENGTH;
+	int wh = WORLD_HEIGHT;
+	int maxW = ww * cw;
+	int maxL = wl * cw;
+	int maxH = wh * cw;
+	const unsigned int ROUNDS = 10;
+
+	std::vector<BlockStorage> chunks(ww * wl * wh);
+	std::vector<uint8_t> blocks(CHUNK_SIZE);
+	for(int y = 0; y < wh; y++){
+		for(int z = 0; z < wl; z++){
+			for(int x = 0; x < ww; x++){
+				for(int j = 0; j < cw; j++){
+					for(int k = 0; k < cw; k++){
+						memcpy(&blocks[(j * cw * cw) + (k * cw)], &_world[((y * cw + j) * maxW * maxL) + ((z * cw + k) * maxW) + x * cw], cw);
+					}
+				}
+				chunks[(((y * wl) + z) * ww) + x].load(blocks.data());
+			}
+		}
+	}
+
+	// The meshes of the first round are kept, so the different ways can be compared face by face
+	ChunkMesher mesher;
+	mesher.init(false);
+	ChunkMesher greedyMesher;
+	greedyMesher.init(true);
+	std::vector<SectionMesh> lookupMeshes(chunks.size() * CHUNK_NUM_SECTIONS);
+	std::vector<SectionMesh> paddedMeshes(chunks.size() * CHUNK_NUM_SECTIONS);
+	std::vector<SectionMesh> greedyMeshes(chunks.size() * CHUNK_NUM_SECTIONS);
+	SectionMesh scratchMeshes[CHUNK_NUM_SECTIONS];
+	// _faceStride is the number of GLuints per face, see ChunkMesher. Every face gets drawn as 6 vertices
+	auto measure = [&](const char* _name, unsigned int _faceStride, std::vector<SectionMesh>& _meshes, auto _generateMesh){
+		auto start = std::chrono::steady_clock::now();
+		for(unsigned int round = 0; round < ROUNDS; round++){
+			for(int y = 0; y < wh; y++){
+				for(int z = 0; z < wl; z++){
+					for(int x = 0; x < ww; x++){
+						SectionMesh* chunkMeshes = round ? scratchMeshes : &_meshes[((((y * wl) + z) * ww) + x) * CHUNK_NUM_SECTIONS];
+						_generateMesh(x, y, z, chunkMeshes);
+					}
+				}
+			}
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		unsigned int numWords = 0;
+		for(auto& mesh : _meshes){
+			numWords += mesh.faces[CHUNK_PASS_OPAQUE].size() + mesh.faces[CHUNK_PASS_CUTOUT].size();
+		}
+		std::cout << "MeshGenerator: " << _name << ": " << (unsigned int)(chunks.size() * ROUNDS / seconds) << " chunks/s, "
+			<< seconds * 1000.0 / (chunks.size() * ROUNDS) << " ms per chunk, " << numWords / _faceStride << " faces in " << numWords << " words, "
+			<< numWords * sizeof(GLuint) << " bytes, " << numWords / _faceStride * 6 << " vertices" << std::endl;
+	};
+
+	// Every lookup gets bounds checked and finds its chunk first, blocks outside the world are air
+	measure("Looking up every block", 1, lookupMeshes, [&](int _x, int _y, int _z, SectionMesh* _meshes){
+		mesher.generateMeshByLookup([&](int _bx, int _by, int _bz){
+			int x = (_x * cw) + _bx;
+			int y = (_y * cw) + _by;
+			int z = (_z * cw) + _bz;
+			if(x < 0 || y < 0 || z < 0 || x >= maxW || y >= maxH || z >= maxL){
+				return (uint8_t)0;
+			}
+			const BlockStorage& chunk = chunks[((((y / cw) * wl) + (z / cw)) * ww) + (x / cw)];
+			return chunk.get(((y % cw) * cw * cw) + ((z % cw) * cw) + (x % cw));
+		}, ALL_CHUNK_SECTIONS, _meshes);
+	});
+
+	// The chunk and its neighbours get copied like in the snapshots the workers are given, then unpacked into the padded buffer
+	std::vector<uint8_t> padded(PADDED_CHUNK_SIZE);
+	std::vector<uint8_t> unpacked(CHUNK_SIZE);
+	BlockStorage air;
+	BlockStorage neighbours[27];
+	auto meshPadded = [&](ChunkMesher& _mesher, int _x, int _y, int _z, uint64_t _sections, SectionMesh* _meshes){
+		for(int dy = -1; dy <= 1; dy++){
+			for(int dz = -1; dz <= 1; dz++){
+				for(int dx = -1; dx <= 1; dx++){
+					int x = _x + dx;
+					int y = _y + dy;
+					int z = _z + dz;
+					bool isInWorld = x >= 0 && y >= 0 && z >= 0 && x < ww && y < wh && z < wl;
+					neighbours[((dy + 1) * 9) + ((dz + 1) * 3) + (dx + 1)] = isInWorld ? chunks[(((y * wl) + z) * ww) + x] : air;
+				}
+			}
+		}
+		fillPaddedBlocks(neighbours, _sections, unpacked.data(), padded.data());
+		_mesher.generateMesh(padded.data(), _sections, _meshes);
+	};
+	measure("Padded buffer", 1, paddedMeshes, [&](int _x, int _y, int _z, SectionMesh* _meshes){
+		meshPadded(mesher, _x, _y, _z, ALL_CHUNK_SECTIONS, _meshes);
+	});
+	measure("Greedy", 2, greedyMeshes, [&](int _x, int _y, int _z, SectionMesh* _meshes){
+		meshPadded(greedyMesher, _x, _y, _z, ALL_CHUNK_SECTIONS, _meshes);
+	});
+
+	// What a single block edit costs to remesh, with only the sections within one block of it remeshed like World::updateMeshes
+	// does, and with every chunk it touches remeshed whole like before the chunks were split into sections.
+	// The blocks don't have to change for the timing, so the edits are only positions
+	const unsigned int NUM_EDITS = 4096;
+	std::mt19937 random(1337);
+	double sectionSeconds = 0.0;
+	double chunkSeconds = 0.0;
+	unsigned int numSections = 0;
+	unsigned int numChunks = 0;
+	for(unsigned int edit = 0; edit < NUM_EDITS; edit++){
+		int position[3] = { (int)(random() % maxW), (int)(random() % maxH), (int)(random() % maxL) };
+		int chunk[3] = { position[0] / cw, position[1] / cw, position[2] / cw };
+		for(int dy = -1; dy <= 1; dy++){
+			for(int dz = -1; dz <= 1; dz++){
+				for(int dx = -1; dx <= 1; dx++){
+					int offset[3] = { dx, dy, dz };
+					int low[3];
+					int high[3];
+					bool isTouched = true;
+					for(int axis = 0; axis < 3; axis++){
+						int local = position[axis] - (chunk[axis] + offset[axis]) * cw;
+						low[axis] = std::max(local - 1, 0);
+						high[axis] = std::min(local + 1, cw - 1);
+						isTouched &= low[axis] <= high[axis];
+					}
+					int x = chunk[0] + dx;
+					int y = chunk[1] + dy;
+					int z = chunk[2] + dz;
+					if(!isTouched || x < 0 || y < 0 || z < 0 || x >= ww || y >= wh || z >= wl) continue;
+
+					uint64_t sections = ChunkMesher::getSectionMask(low, high);
+					auto start = std::chrono::steady_clock::now();
+					meshPadded(mesher, x, y, z, sections, scratchMeshes);
+					auto middle = std::chrono::steady_clock::now();
+					meshPadded(mesher, x, y, z, ALL_CHUNK_SECTIONS, scratchMeshes);
+					auto end = std::chrono::steady_clock::now();
+					sectionSeconds += std::chrono::duration<double>(middle - start).count();
+					chunkSeconds += std::chrono::duration<double>(end - middle).count();
+					numSections += std::popcount(sections);
+					numChunks++;
+				}
+			}
+		}
+	}
+	std::cout << "MeshGenerator: Remeshing after a single block edit: " << sectionSeconds * 1000.0 / NUM_EDITS << " ms for " << (float)numSections / NUM_EDITS
+		<< " sections, " << chunkSeconds * 1000.0 / NUM_EDITS << " ms for " << (float)numChunks / NUM_EDITS << " whole chunks" << std::endl;
+
+	auto compareMeshes = [&](const char* _name, const std::vector<SectionMesh>& _meshes, const std::vector<SectionMesh>& _expectedMeshes){
+		unsigned int numDifferent = 0;
+		for(unsigned int i = 0; i < _meshes.size(); i++){
+			for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+				if(_meshes[i].faces[pass] == _expectedMeshes[i].faces[pass]) continue;
+				if(!numDifferent){
+					unsigned int chunk = i / CHUNK_NUM_SECTIONS;
+					std::cout << "MeshGenerator: " << _name << ": Section " << i % CHUNK_NUM_SECTIONS << " of chunk " << chunk % ww << ", " << chunk / (ww * wl) << ", " << (chunk / ww) % wl
+						<< " differs in pass " << pass << ", " << _meshes[i].faces[pass].size() << " faces instead of " << _expectedMeshes[i].faces[pass].size() << std::endl;
+				}
+				numDifferent++;
+			}
+		}
+		if(numDifferent){
+			std::cout << "MeshGenerator: " << _name << ": " << numDifferent << " section meshes differ" << std::endl;
+		}
+		return !numDifferent;
+	};
+	// The padded buffer has to give the same faces in the same order as looking up every block
+	bool success = compareMeshes("Padded buffer", paddedMeshes, lookupMeshes);
+
+	// The greedy quads are split back into one face per block, which has to give the same faces as the naive mesher in any order
+	std::vector<SectionMesh> splitMeshes(greedyMeshes.size());
+	for(unsigned int i = 0; i < greedyMeshes.size(); i++){
+		for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+			const std::vector<GLuint>& quads = greedyMeshes[i].faces[pass];
+			std::vector<GLuint>& faces = splitMeshes[i].faces[pass];
+			for(unsigned int j = 0; j < quads.size(); j += 2){
+				unsigned int size[3] = { quads[j + 1] & 63, (quads[j + 1] >> 6) & 63, (quads[j + 1] >> 12) & 63 };
+				for(unsigned int y = 0; y < size[1]; y++){
+					for(unsigned int z = 0; z < size[2]; z++){
+						for(unsigned int x = 0; x < size[0]; x++){
+							faces.push_back(quads[j] + (x | y << 5 | z << 10));
+						}
+					}
+				}
+			}
+			std::sort(faces.begin(), faces.end());
+			std::sort(paddedMeshes[i].faces[pass].begin(), paddedMeshes[i].faces[pass].end());
+		}
+	}
+	return compareMeshes("Greedy", splitMeshes, paddedMeshes) && success;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BlockStorage.hpp"
+#include "ChunkMesher.hpp"
+#include "ChunkVisibility.hpp"
+#include <glm/glm.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+// Everything a worker needs to mesh a chunk. Copies of a block storage share their packed indices until one
+// of them gets edited, so taking a snapshot is cheap and later edits of the world never show up in it
+struct MeshRequest {
+	glm::ivec3 position; // In chunk coordinates
+	uint64_t id = 0; // Increases with every request, so older meshes of the same chunk can be told apart
+	uint64_t sections = 0; // Mask of the sections to mesh, see ChunkMesher
+	BlockStorage blocks[27]; // The chunk and its neighbours, indexed as ((dy + 1) * 9) + ((dz + 1) * 3) + (dx + 1). Missing neighbours are air
+};
+
+struct MeshResult {
+	glm::ivec3 position;
+	uint64_t id = 0;
+	uint64_t sections = 0;
+	SectionMesh meshes[CHUNK_NUM_SECTIONS]; // Only the sections in the mask are meshed
+	uint16_t visibility = ALL_CHUNK_FACES_CONNECTED; // Of the whole chunk, see ChunkVisibility
+};
+
+// Meshes chunks on a pool of worker threads, every worker has its own mesher and padded buffer.
+// The workers also find out which faces of the chunk are connected, since they have its blocks unpacked anyway.
+// The game thread hands over snapshots with request() and picks up the finished meshes with collect()
+class MeshGenerator {
+public:
+
+	// 0 threads uses one per core, minus the one the game runs on
+	void init(bool _greedy, unsigned int _numThreads = 0);
+	void destroy();
+
+	void request(MeshRequest&& _request);
+	void collect(std::vector<MeshResult>& _results);
+
+	// Requests that were handed over but aren't collected yet
+	unsigned int getNumPending() const;
+	// Average over every mesh generated so far, in milliseconds
+	double getAverageMeshTime() const;
+	unsigned int getNumThreads() const;
+
+	// Copies what meshing the sections reads of the chunk and the border blocks of its neighbours into a padded buffer,
+	// _unpacked is scratch space of CHUNK_SIZE blocks, it holds all blocks of the chunk afterwards
+	static void fillPaddedBlocks(const BlockStorage* _blocks, uint64_t _sections, uint8_t* _unpacked, uint8_t* _padded);
+
+	// Prints how many chunks of _world per second get meshed on one thread and how large the meshes are, by looking up every
+	// block through the world like meshing used to, with the padded buffer and with the greedy mesher. _world is in the layout
+	// of RegionStorage::readLegacyWorld. Returns false if the padded buffer doesn't give the same faces as the lookups for every
+	// section, or if the greedy quads split into single faces don't give the same set of faces
+	static bool benchmark(const std::vector<uint8_t>& _world);
+
+private:
+
+	void run();
+
+	bool m_isGreedy = false;
+	std::vector<std::thread> m_threads;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_requestCondition; // Signaled when a chunk gets requested or the workers should stop
+	std::deque<MeshRequest> m_requests;
+	std::vector<MeshResult> m_finished;
+	unsigned int m_numBusy = 0;
+	bool m_isRunning = false;
+	double m_totalMeshTime = 0.0; // In seconds
+	unsigned int m_numMeshesGenerated = 0;
+
+};
@@ -0,0 +1,135 @@
+#include "MultiDrawRenderer.hpp"
+#include <algorithm>
+#include <cstring>
+
+// Built against a GL loader without the 4.3 functions, there's only the fallback
+#ifdef GL_VERSION_4_3
+
+bool MultiDrawRenderer::isSupported(std::string& _reason){
+	GLint major = 0;
+	GLint minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if(major < 4 || (major == 4 && minor < 3)){
+		_reason = "the context is GL " + std::to_string(major) + "." + std::to_string(minor) + " but multi draw indirect needs 4.3";
+		return false;
+	}
+	GLint numExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+	for(GLint i = 0; i < numExtensions; i++){
+		const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if(!strcmp(extension, "GL_ARB_shader_draw_parameters")){
+			return true;
+		}
+	}
+	_reason = "GL_ARB_shader_draw_parameters is missing";
+	return false;
+}
+
+void MultiDrawRenderer::init(ChunkBuffer* _buffer){
+	m_buffer = _buffer;
+
+	// The origins of every arena get bound as a range of one storage buffer, which has to start at a multiple of this
+	GLint alignment = 0;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	m_originAlignment = std::max(1, alignment / (GLint)sizeof(glm::vec4));
+
+	glGenBuffers(1, &m_commandBufferID);
+	glGenBuffers(1, &m_originBufferID);
+}
+
+void MultiDrawRenderer::destroy(){
+	glDeleteBuffers(1, &m_commandBufferID);
+	glDeleteBuffers(1, &m_originBufferID);
+	m_commandBufferID = 0;
+	m_originBufferID = 0;
+	m_arenaDraws.clear();
+}
+
+void MultiDrawRenderer::render(const std::vector<Chunk*>& _chunks, unsigned int _pass){
+	m_arenaDraws.resize(m_buffer->getNumArenas());
+	for(auto& draws : m_arenaDraws){
+		draws.commands.resize(0);
+		draws.origins.resize(0);
+	}
+	for(Chunk* c : _chunks){
+		if(!c->getNumFaces(_pass)) continue;
+		const ChunkBufferRange& range = c->getBufferRange();
+		ArenaDraws& draws = m_arenaDraws[range.arena];
+		glm::vec4 origin(c->x, c->y, c->z, 0.0f);
+		for(auto& section : c->sections){
+			unsigned int count = section.counts[_pass];
+			if(!count) continue;
+			unsigned int first = range.first + section.first;
+			for(unsigned int pass = 0; pass < _pass; pass++){
+				first += section.counts[pass];
+			}
+			// The instanced attributes start at baseInstance, which points them at the first face of the section
+			draws.commands.push_back({ 6, count, 0, first });
+			draws.origins.push_back(origin);
+		}
+	}
+
+	m_commands.resize(0);
+	m_origins.resize(0);
+	for(auto& draws : m_arenaDraws){
+		m_commands.insert(m_commands.end(), draws.commands.begin(), draws.commands.end());
+		m_origins.insert(m_origins.end(), draws.origins.begin(), draws.origins.end());
+		m_origins.resize(((m_origins.size() + m_originAlignment - 1) / m_originAlignment) * m_originAlignment);
+	}
+	if(m_commands.empty()){
+		return;
+	}
+
+	// Both buffers get orphaned every render, so the driver doesn't have to wait for the previous draw to finish with them
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBufferID);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commands.size() * sizeof(DrawArraysIndirectCommand), m_commands.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_originBufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_origins.size() * sizeof(glm::vec4), m_origins.data(), GL_STREAM_DRAW);
+
+	GLsizei stride = sizeof(GLuint) * m_buffer->getFaceStride();
+	size_t firstCommand = 0;
+	size_t firstOrigin = 0;
+	for(unsigned int arena = 0; arena < m_arenaDraws.size(); arena++){
+		ArenaDraws& draws = m_arenaDraws[arena];
+		if(draws.commands.empty()) continue;
+
+		// gl_DrawIDARB starts at 0 for every call, so the origins are bound from the arena's first one on
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, m_originBufferID, firstOrigin * sizeof(glm::vec4), draws.origins.size() * sizeof(glm::vec4));
+		glBindVertexArray(m_buffer->getVaoID(arena));
+		glBindBuffer(GL_ARRAY_BUFFER, m_buffer->getBufferID(arena));
+		glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, stride, (void*)0);
+		if(m_buffer->getFaceStride() > 1){
+			glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, stride, (void*)sizeof(GLuint));
+		}
+		glMultiDrawArraysIndirect(GL_TRIANGLES, (void*)(firstCommand * sizeof(DrawArraysIndirectCommand)), draws.commands.size(), 0);
+
+		firstCommand += draws.commands.size();
+		firstOrigin += ((draws.origins.size() + m_originAlignment - 1) / m_originAlignment) * m_originAlignment;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+#else
+
+bool MultiDrawRenderer::isSupported(std::string& _reason){
+	_reason = "the GL loader was built without GL 4.3";
+	return false;
+}
+
+void MultiDrawRenderer::init(ChunkBuffer* _buffer){
+	m_buffer = _buffer;
+}
+
+void MultiDrawRenderer::destroy(){
+}
+
+void MultiDrawRenderer::render(const std::vector<Chunk*>&, unsigned int){
+}
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Chunk.hpp"
+#include "ChunkBuffer.hpp"
+#include <GLAD/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+
+// Layout glMultiDrawArraysIndirect reads the draws in
+struct DrawArraysIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint first;
+	GLuint baseInstance;
+};
+
+// Draws every chunk of a pass with one glMultiDrawArraysIndirect call per arena of the ChunkBuffer. Every non-empty
+// section gets a command that starts its instances at the section's first face, and the chunk vertex shader looks
+// up the origin of the chunk by the draw ID in a storage buffer.
+// Needs GL 4.3 and ARB_shader_draw_parameters, World falls back to drawing the chunks one by one without them
+class MultiDrawRenderer {
+public:
+
+	// When it isn't, _reason says why, so it can be logged
+	static bool isSupported(std::string& _reason);
+
+	// The chunks that get drawn have to keep their meshes in _buffer
+	void init(ChunkBuffer* _buffer);
+	void destroy();
+
+	// The chunk shader of the pass has to be bound
+	void render(const std::vector<Chunk*>& _chunks, unsigned int _pass);
+
+private:
+
+	// The commands and origins of every arena, reused every render
+	struct ArenaDraws {
+		std::vector<DrawArraysIndirectCommand> commands;
+		std::vector<glm::vec4> origins; // One per command
+	};
+
+	ChunkBuffer* m_buffer = nullptr;
+	GLuint m_commandBufferID = 0;
+	GLuint m_originBufferID = 0;
+	std::vector<ArenaDraws> m_arenaDraws;
+	std::vector<DrawArraysIndirectCommand> m_commands; // Of all arenas, one after another
+	std::vector<glm::vec4> m_origins; // Same, but every arena starts at a multiple of m_originAlignment
+	unsigned int m_originAlignment = 1; // In origins
+
+};
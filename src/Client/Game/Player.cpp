@@ -20,7 +20,9 @@ void Player::init(Camera* _camera, ParticleHandler* _handler, World* _world, Net
 	m_networkManager = _nManager;
 
 	hotbar.init();
-	position = glm::vec3(36, 32, 32);
+	// Spawning on top of whatever is below the spawn point, when streaming the chunks aren't loaded yet so we fall back to a fixed height
+	int surfaceHeight = m_world->getSurfaceHeight(36, 32);
+	position = glm::vec3(36, surfaceHeight >= 0 ? surfaceHeight + 1 : 32, 32);
 	gamemode = SURVIVAL;
 	hotbar.items[0].id = ItemID::GRASS;
 	hotbar.items[0].count = 22;
@@ -128,7 +130,7 @@ void Player::getVisibleBlocks() {
 		visibleBlocks.breakableBlock = vecToBlock(rayPosition);
 		uint8_t blockID = m_world->getBlock(visibleBlocks.breakableBlock.x, visibleBlocks.breakableBlock.y, visibleBlocks.breakableBlock.z);
 
-		if (blockID) {
+		if (isBlockSolid(blockID)) {
 			visibleBlocks.lookingAtBlock = true;
 			rayPosition -= m_camera->getForward() * (REACH_DISTANCE / (float)PRECISION);
 			visibleBlocks.placeableBlock = vecToBlock(rayPosition);
@@ -138,14 +140,14 @@ void Player::getVisibleBlocks() {
 }
 
 void Player::placeBlock() {
-	m_world->setBlock(visibleBlocks.placeableBlock.x, visibleBlocks.placeableBlock.y, visibleBlocks.placeableBlock.z, Converter::itemIDToBlockID(hotbar.getSelectedItem().id));
+	m_world->setBlock(visibleBlocks.placeableBlock.x, visibleBlocks.placeableBlock.y, visibleBlocks.placeableBlock.z, Converter::itemIDToBlockID(hotbar.getSelectedItem().id), true);
 }
 
 void Player::breakBlock() {
 	glm::ivec3 vb = visibleBlocks.breakableBlock;
 
 	uint8_t blockID = m_world->getBlock(vb.x, vb.y, vb.z);
-	m_world->setBlock(vb.x, vb.y, vb.z, 0);
+	m_world->setBlock(vb.x, vb.y, vb.z, 0, true);
 	m_particleHandler->placeParticlesAroundBlock(vb.x, vb.y, vb.z, blockID);
 }
 
@@ -159,7 +161,7 @@ void Player::collideWithWorld(){
 			for(int z = -1; z < 2; z++){
 				glm::ivec3 iBlockPos = playerCenterBlock + glm::ivec3(x, y, z);
 
-				if(m_world->getBlock(iBlockPos.x, iBlockPos.y, iBlockPos.z)){
+				if(isBlockSolid(m_world->getBlock(iBlockPos.x, iBlockPos.y, iBlockPos.z))){
 					glm::vec3 blockPos = glm::vec3(iBlockPos.x, iBlockPos.y, iBlockPos.z);
 					AABB blockBox(blockPos, glm::vec3(1, 1, 1));
 					blocksToCollideWith.push_back(blockBox);
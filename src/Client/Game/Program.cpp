@@ -2,6 +2,7 @@
 #include <iostream>
 
 void Program::run(){
+	m_startTime = std::chrono::steady_clock::now();
 	initSystems();
 	gameloop();
 	cleanUp();
@@ -22,6 +23,7 @@ void Program::initSystems(){
 }
 
 void Program::gameloop(){
+	bool firstFrame = true;
 	m_deltaTimer.restart();
 	while(m_state != GameStates::EXIT){
 		Window::clear();
@@ -42,6 +44,12 @@ void Program::gameloop(){
 		GUIRenderer::render();
 
 		Window::update();
+
+		if(firstFrame){
+			firstFrame = false;
+			std::chrono::duration<double, std::milli> coldStart = std::chrono::steady_clock::now() - m_startTime;
+			std::cout << "Program: First frame rendered after " << coldStart.count() << " ms (mmapWorld: " << m_settings.mmapWorld << ")" << std::endl;
+		}
 	}
 }
 
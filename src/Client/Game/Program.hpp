@@ -5,13 +5,13 @@
 #include "Settings.hpp"
 #include "DebugMenu.hpp"
 #include "GUIRenderer.hpp"
-#include "BlockTextureHandler.hpp"
 #include "Window.hpp"
 #include "Clock.hpp"
 #include "TextureArray.hpp"
 #include "Converter.hpp"
 #include "GUIUVLoader.hpp"
 #include "FilePathManager.hpp"
+#include <chrono>
 
 class Program {
 public:
@@ -28,6 +28,7 @@ private:
 	GameStates m_state = GameStates::PLAY;
 	Settings m_settings;
 	Clock m_deltaTimer;
+	std::chrono::steady_clock::time_point m_startTime; // Used to report the cold start time
 	/*
 	sf::IpAddress m_ip;
 	*/
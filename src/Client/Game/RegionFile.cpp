@@ -0,0 +1,136 @@
+#include "RegionFile.hpp"
+#include <iostream>
+#include <cstring>
+
+const char REGION_MAGIC[4] = { 'T', 'T', 'R', 'G' };
+const unsigned int REGION_HEADER_SIZE = sizeof(REGION_MAGIC) + sizeof(uint32_t) + REGION_SIZE * sizeof(RegionEntry);
+
+uint32_t roundToSector(uint32_t _size){
+	return (_size + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE * REGION_SECTOR_SIZE;
+}
+
+uint32_t swapBytes(uint32_t _value){
+	return (_value >> 24) | ((_value >> 8) & 0xFF00) | ((_value << 8) & 0xFF0000) | (_value << 24);
+}
+
+bool RegionFile::open(const std::string& _path, bool _mapped){
+	for(unsigned int i = 0; i < REGION_SIZE; i++){
+		m_entries[i] = RegionEntry();
+		m_rewritten[i] = false;
+	}
+
+	m_file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+	if(!m_file.is_open()){
+		// Creating an empty region with a zeroed header
+		std::ofstream os(_path, std::ios::out | std::ios::binary);
+		if(os.fail()){
+			std::cout << "RegionFile: Could not create file: " << _path << std::endl;
+			return false;
+		}
+		std::vector<uint8_t> header(roundToSector(REGION_HEADER_SIZE), 0);
+		memcpy(header.data(), REGION_MAGIC, sizeof(REGION_MAGIC));
+		memcpy(header.data() + sizeof(REGION_MAGIC), &REGION_VERSION, sizeof(uint32_t));
+		os.write((char*)header.data(), header.size());
+		os.close();
+
+		m_file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+		if(!m_file.is_open()){
+			std::cout << "RegionFile: Could not open file: " << _path << std::endl;
+			return false;
+		}
+	}
+
+	char magic[4];
+	uint32_t version = 0;
+	m_file.read(magic, sizeof(magic));
+	m_file.read((char*)&version, sizeof(version));
+	m_file.read((char*)m_entries, sizeof(m_entries));
+	if(!m_file.good() || memcmp(magic, REGION_MAGIC, sizeof(magic)) || version != REGION_VERSION){
+		if(version == swapBytes(REGION_VERSION)){
+			std::cout << "RegionFile: Region file was written with the other byte order: " << _path << std::endl;
+		}else{
+			std::cout << "RegionFile: Invalid region file: " << _path << std::endl;
+		}
+		m_file.close();
+		return false;
+	}
+
+	m_file.seekg(0, std::ios::end);
+	m_endOfFile = roundToSector(m_file.tellg());
+
+	// Falling back to stream reads is fine if the mapping fails
+	m_mappedEnd = 0;
+	if(_mapped){
+		m_mappedEnd = m_endOfFile;
+		m_mapping = std::make_shared<MappedFile>();
+		if(!m_mapping->open(_path)) m_mapping.reset();
+	}
+	return true;
+}
+
+void RegionFile::close(){
+	// Chunks still viewing the mapped pages keep it alive, the last one to go unmaps it
+	m_mapping.reset();
+	m_file.close();
+}
+
+bool RegionFile::hasChunk(unsigned int _index) const {
+	return m_entries[_index].offset != 0;
+}
+
+bool RegionFile::loadChunk(unsigned int _index, BlockStorage& _blocks){
+	const RegionEntry& entry = m_entries[_index];
+	if(!entry.offset) return false;
+
+	if(m_mapping && !m_rewritten[_index] && entry.offset + entry.size <= m_mapping->getSize()){
+		if(!_blocks.deserialize(m_mapping->getData() + entry.offset, entry.size, m_mapping)){
+			std::cout << "RegionFile: Chunk " << _index << " is corrupt" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	m_buffer.resize(entry.size);
+	m_file.seekg(entry.offset);
+	m_file.read((char*)m_buffer.data(), entry.size);
+	if(!m_file.good()){
+		m_file.clear();
+		std::cout << "RegionFile: Failed to read chunk " << _index << std::endl;
+		return false;
+	}
+	if(!_blocks.deserialize(m_buffer.data(), entry.size)){
+		std::cout << "RegionFile: Chunk " << _index << " is corrupt" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool RegionFile::saveChunk(unsigned int _index, const BlockStorage& _blocks){
+	_blocks.serialize(m_buffer);
+	uint32_t size = m_buffer.size();
+
+	RegionEntry& entry = m_entries[_index];
+	// MAP_PRIVATE doesn't keep pages we write to through the stream from changing under the views into them
+	bool isMapped = entry.offset < m_mappedEnd;
+	if(!entry.offset || isMapped || roundToSector(size) > roundToSector(entry.size)){
+		entry.offset = m_endOfFile;
+		m_endOfFile += roundToSector(size);
+	}
+	entry.size = size;
+	m_rewritten[_index] = true;
+
+	// Padding the blob to a whole number of sectors keeps every blob sector aligned
+	m_buffer.resize(roundToSector(size), 0);
+	m_file.seekp(entry.offset);
+	m_file.write((char*)m_buffer.data(), m_buffer.size());
+
+	m_file.seekp(sizeof(REGION_MAGIC) + sizeof(uint32_t) + _index * sizeof(RegionEntry));
+	m_file.write((char*)&entry, sizeof(RegionEntry));
+	m_file.flush();
+	if(!m_file.good()){
+		m_file.clear();
+		std::cout << "RegionFile: Failed to write chunk " << _index << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BlockStorage.hpp"
+#include "MappedFile.hpp"
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include <memory>
+
+/*
+	A region file stores a REGION_WIDTH^3 block of chunks so any single chunk can be read or written without touching the rest.
+
+	Layout (host byte order, the packed index words get read in place so the file has to match the machine. A file written
+	with the other byte order has its version byte swapped and gets rejected when opened):
+	- Header: "TTRG" magic, uint32 version, then REGION_SIZE entries of { uint32 offset, uint32 size }. An offset of 0 means the chunk isn't stored
+	- Chunk blobs, each starting on a REGION_SECTOR_SIZE boundary. A blob is rewritten in place when its new size still fits its sectors, otherwise it's appended to the end of the file
+
+	When opened as mapped, blobs are decoded straight from the mapped pages and packed chunks keep pointing into them until they're edited.
+	Those chunks share ownership of the mapping, so the region file can be closed while they're still around.
+	Blobs written after the file got mapped are read through the stream instead. Blobs inside the mapped range never get rewritten
+	in place, loaded chunks and their snapshots on other threads may still be reading those pages, so they move to the end of the file.
+	That includes mappings made by an earlier open of the same file, which is why the range is everything the file held when opened.
+
+	Chunk blob:
+	- uint8 codec (0 = packed, 1 = run length encoded), uint8 bits per index, uint16 palette size, palette entries
+	- Packed: the palette index words of BlockStorage, starting on an 8 byte boundary of the blob
+	- Run length encoded: { uint16 length, uint8 palette index } runs covering the chunk in index order
+	- A uniform chunk has 0 bits per index and no payload at all
+*/
+
+const unsigned int REGION_WIDTH = 8; // In chunks, along every axis
+const unsigned int REGION_SIZE = REGION_WIDTH * REGION_WIDTH * REGION_WIDTH;
+const unsigned int REGION_SECTOR_SIZE = 256;
+const uint32_t REGION_VERSION = 1;
+
+struct RegionEntry {
+	uint32_t offset = 0;
+	uint32_t size = 0;
+};
+
+class RegionFile {
+public:
+
+	bool open(const std::string& _path, bool _mapped);
+	void close();
+
+	// _index is the position of the chunk within the region: (y * REGION_WIDTH * REGION_WIDTH) + (z * REGION_WIDTH) + x
+	bool hasChunk(unsigned int _index) const;
+	bool loadChunk(unsigned int _index, BlockStorage& _blocks);
+	bool saveChunk(unsigned int _index, const BlockStorage& _blocks);
+
+private:
+
+	std::fstream m_file;
+	std::shared_ptr<MappedFile> m_mapping;
+	uint32_t m_mappedEnd = 0; // Blobs starting below this may be viewed through a mapping and are never rewritten in place
+	RegionEntry m_entries[REGION_SIZE];
+	bool m_rewritten[REGION_SIZE] = {}; // Chunks whose blob changed since the file got mapped
+	uint32_t m_endOfFile = 0;
+	std::vector<uint8_t> m_buffer;
+
+};
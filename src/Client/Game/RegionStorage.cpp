@@ -0,0 +1,175 @@
+#include "RegionStorage.hpp"
+#include "TTConfig.hpp"
+#include <iostream>
+#include <filesystem>
+#include <cstring>
+
+int regionFloorDiv(int _a, int _b){
+	return (_a >= 0 ? _a : _a - _b + 1) / _b;
+}
+
+uint64_t getRegionKey(int _x, int _y, int _z){
+	return ((uint64_t)(_x & 0xFFFFFF) << 40) | ((uint64_t)(_z & 0xFFFFFF) << 16) | (uint64_t)(_y & 0xFFFF);
+}
+
+unsigned int getIndexInRegion(int _x, int _y, int _z){
+	int rw = REGION_WIDTH;
+	int x = _x - regionFloorDiv(_x, rw) * rw;
+	int y = _y - regionFloorDiv(_y, rw) * rw;
+	int z = _z - regionFloorDiv(_z, rw) * rw;
+	return (y * rw * rw) + (z * rw) + x;
+}
+
+void RegionStorage::init(const std::string& _folder, bool _mapped){
+	m_folder = _folder;
+	m_mapped = _mapped;
+	std::filesystem::create_directories(m_folder);
+}
+
+bool RegionStorage::loadChunk(int _x, int _y, int _z, BlockStorage& _blocks){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	RegionFile* region = getRegion(_x, _y, _z, false).file;
+	if(!region) return false;
+	return region->loadChunk(getIndexInRegion(_x, _y, _z), _blocks);
+}
+
+bool RegionStorage::saveChunk(int _x, int _y, int _z, const BlockStorage& _blocks){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	RegionFile* region = getRegion(_x, _y, _z, true).file;
+	if(!region) return false;
+	return region->saveChunk(getIndexInRegion(_x, _y, _z), _blocks);
+}
+
+void RegionStorage::retainChunk(int _x, int _y, int _z){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	getRegion(_x, _y, _z, false).numChunks++;
+}
+
+void RegionStorage::releaseChunk(int _x, int _y, int _z){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Region& region = getRegion(_x, _y, _z, false);
+	if(region.numChunks > 0) region.numChunks--;
+	if(region.numChunks == 0) closeIdleRegions();
+}
+
+void RegionStorage::destroy(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for(auto& it : m_regions){
+		if(it.second.file){
+			it.second.file->close();
+			delete it.second.file;
+		}
+	}
+	m_regions.clear();
+}
+
+unsigned int RegionStorage::getNumOpenRegions(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	unsigned int count = 0;
+	for(auto& it : m_regions){
+		count += it.second.file != nullptr;
+	}
+	return count;
+}
+
+RegionStorage::Region& RegionStorage::getRegion(int _x, int _y, int _z, bool _create){
+	int rw = REGION_WIDTH;
+	int rx = regionFloorDiv(_x, rw);
+	int ry = regionFloorDiv(_y, rw);
+	int rz = regionFloorDiv(_z, rw);
+	uint64_t key = getRegionKey(rx, ry, rz);
+
+	// Regions that don't exist on disk are remembered with no file so we don't hit the filesystem for every missing chunk
+	auto it = m_regions.find(key);
+	bool isNew = it == m_regions.end();
+	Region& region = isNew ? m_regions[key] : it->second;
+	region.lastUse = ++m_useCounter;
+	if(!isNew && (region.file || !_create)) return region;
+
+	std::string path = m_folder + "r." + std::to_string(rx) + "." + std::to_string(ry) + "." + std::to_string(rz) + ".dat";
+	if(_create || std::filesystem::exists(path)){
+		region.file = new RegionFile;
+		if(!region.file->open(path, m_mapped)){
+			delete region.file;
+			region.file = nullptr;
+		}
+	}
+
+	// The region we just used is the most recent one, so it's never the one getting closed
+	if(isNew) closeIdleRegions();
+	return region;
+}
+
+void RegionStorage::closeIdleRegions(){
+	// There are only as many regions as the render distance spans plus the idle ones, so a linear search for the oldest is fine
+	while(true){
+		unsigned int numIdle = 0;
+		auto oldest = m_regions.end();
+		for(auto it = m_regions.begin(); it != m_regions.end(); it++){
+			if(it->second.numChunks) continue;
+			numIdle++;
+			if(oldest == m_regions.end() || it->second.lastUse < oldest->second.lastUse) oldest = it;
+		}
+		if(numIdle <= MAX_IDLE_REGIONS) return;
+
+		if(oldest->second.file){
+			oldest->second.file->close();
+			delete oldest->second.file;
+		}
+		m_regions.erase(oldest);
+	}
+}
+
+bool RegionStorage::readLegacyWorld(const std::string& _legacyPath, std::vector<uint8_t>& _blocks){
+	std::ifstream file(_legacyPath, std::ios::in | std::ios::binary);
+	if (!file.good()) {
+		std::cout << "RegionStorage: Could not open file: " << _legacyPath << std::endl;
+		return false;
+	}
+
+	_blocks.resize(WORLD_WIDTH * WORLD_LENGTH * WORLD_HEIGHT * CHUNK_SIZE);
+	file.read((char*)_blocks.data(), _blocks.size());
+	if ((unsigned int)file.gcount() != _blocks.size()) {
+		std::cout << "RegionStorage: Unexpected end of file: " << _legacyPath << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool RegionStorage::convertLegacyWorld(const std::string& _legacyPath, const std::string& _folder){
+	// The legacy file stores the world as one flat array, which gets split up into chunks
+	std::vector<uint8_t> data;
+	if(!readLegacyWorld(_legacyPath, data)){
+		return false;
+	}
+
+	unsigned int ww = WORLD_WIDTH;
+	unsigned int wl = WORLD_LENGTH;
+	unsigned int wh = WORLD_HEIGHT;
+	unsigned int cw = CHUNK_WIDTH;
+	unsigned int maxW = ww * cw;
+	unsigned int maxL = wl * cw;
+
+	RegionStorage storage;
+	storage.init(_folder);
+
+	std::vector<uint8_t> blocks(CHUNK_SIZE);
+	BlockStorage chunk;
+	bool success = true;
+	for(unsigned int y = 0; y < wh; y++){
+		for(unsigned int z = 0; z < wl; z++){
+			for(unsigned int x = 0; x < ww; x++){
+				for(unsigned int j = 0; j < cw; j++){
+					for(unsigned int k = 0; k < cw; k++){
+						memcpy(&blocks[(j * cw * cw) + (k * cw)], &data[((y * cw + j) * maxW * maxL) + ((z * cw + k) * maxW) + x * cw], cw);
+					}
+				}
+				chunk.load(blocks.data());
+				success &= storage.saveChunk(x, y, z, chunk);
+			}
+		}
+	}
+
+	storage.destroy();
+	return success;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "RegionFile.hpp"
+#include <unordered_map>
+#include <string>
+#include <mutex>
+
+const unsigned int MAX_IDLE_REGIONS = 8; // Regions without loaded chunks that stay open, walking back over a region border doesn't reopen them
+
+// Maps chunk coordinates to the region files of a world folder, opening them on demand.
+// Loading and saving is safe from multiple threads, the world loads on the main thread while WorldSaver writes in the background.
+// The world tells us which chunks it holds, regions none of them are in get closed once more than MAX_IDLE_REGIONS pile up,
+// so a streaming world doesn't keep every region it ever passed through open. Chunks viewing a mapped region keep the mapping alive themselves.
+class RegionStorage {
+public:
+
+	// Mapped regions decode chunks straight from the mapped file instead of reading them into a buffer first
+	void init(const std::string& _folder, bool _mapped = false);
+	bool loadChunk(int _x, int _y, int _z, BlockStorage& _blocks);
+	bool saveChunk(int _x, int _y, int _z, const BlockStorage& _blocks);
+	// Called whenever the world adds or removes a chunk, whether it came from a region file or not
+	void retainChunk(int _x, int _y, int _z);
+	void releaseChunk(int _x, int _y, int _z);
+	void destroy();
+
+	unsigned int getNumOpenRegions();
+
+	// One-shot conversion of the flat WORLD_WIDTH * WORLD_HEIGHT * WORLD_LENGTH lobby layout into region files
+	static bool convertLegacyWorld(const std::string& _legacyPath, const std::string& _folder);
+	// Reads the flat lobby layout in one go. Blocks are indexed as (y * maxW * maxL) + (z * maxW) + x, maxW and maxL being
+	// the width and length of the world in blocks
+	static bool readLegacyWorld(const std::string& _legacyPath, std::vector<uint8_t>& _blocks);
+
+private:
+
+	struct Region {
+		RegionFile* file = nullptr; // nullptr when the region doesn't exist on disk
+		unsigned int numChunks = 0; // Chunks of the world in this region
+		uint64_t lastUse = 0;
+	};
+
+	Region& getRegion(int _x, int _y, int _z, bool _create);
+	void closeIdleRegions();
+
+	std::string m_folder;
+	bool m_mapped = false;
+	std::unordered_map<uint64_t, Region> m_regions;
+	uint64_t m_useCounter = 0;
+	std::mutex m_mutex; // Guards m_regions and the region files, which share a stream and buffer per file
+
+};
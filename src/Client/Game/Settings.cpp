@@ -16,6 +16,28 @@ void Settings::loadFromFile(){
 			is >> isDebugToggled;
 		}else if(type == "legacyOutline:"){
 			is >> legacyOutline;
+		}else if(type == "mmapWorld:"){
+			is >> mmapWorld;
+		}else if(type == "streamWorld:"){
+			is >> streamWorld;
+		}else if(type == "renderDistance:"){
+			is >> renderDistance;
+		}else if(type == "autosaveInterval:"){
+			is >> autosaveInterval;
+		}else if(type == "worldSeed:"){
+			is >> worldSeed;
+		}else if(type == "generatorThreads:"){
+			is >> generatorThreads;
+		}else if(type == "meshThreads:"){
+			is >> meshThreads;
+		}else if(type == "greedyMeshing:"){
+			is >> greedyMeshing;
+		}else if(type == "multiDrawIndirect:"){
+			is >> multiDrawIndirect;
+		}else if(type == "occlusionCulling:"){
+			is >> occlusionCulling;
+		}else if(type == "meshArenaSize:"){
+			is >> meshArenaSize;
 		}
 	}
 	is.close();
@@ -31,5 +53,16 @@ void Settings::writeToFile(){
 	os << "isVignetteToggled: " << isVignetteToggled << std::endl;
 	os << "isDebugToggled: " << isDebugToggled << std::endl;
 	os << "legacyOutline: " << legacyOutline << std::endl;
+	os << "mmapWorld: " << mmapWorld << std::endl;
+	os << "streamWorld: " << streamWorld << std::endl;
+	os << "renderDistance: " << renderDistance << std::endl;
+	os << "autosaveInterval: " << autosaveInterval << std::endl;
+	os << "worldSeed: " << worldSeed << std::endl;
+	os << "generatorThreads: " << generatorThreads << std::endl;
+	os << "meshThreads: " << meshThreads << std::endl;
+	os << "greedyMeshing: " << greedyMeshing << std::endl;
+	os << "multiDrawIndirect: " << multiDrawIndirect << std::endl;
+	os << "occlusionCulling: " << occlusionCulling << std::endl;
+	os << "meshArenaSize: " << meshArenaSize << std::endl;
 	os.close();
 }
@@ -14,4 +14,15 @@ public:
 	bool legacyOutline = true;
     bool isVignetteToggled = true;
 	bool isDebugToggled = true;
+	bool streamWorld = false;
+	bool mmapWorld = true;
+	int renderDistance = 8; // In chunks, only used when streaming the world
+	int autosaveInterval = 60; // In seconds, 0 disables autosaving
+	unsigned int worldSeed = 1337;
+	unsigned int generatorThreads = 0; // 0 uses one thread per core, minus the one the game runs on
+	unsigned int meshThreads = 0; // 0 uses one thread per core, minus the one the game runs on
+	bool greedyMeshing = false; // Merges faces into larger quads, fewer faces but slower to mesh
+	bool multiDrawIndirect = true; // Draws all chunks with one call per pass where the GL version allows it
+	bool occlusionCulling = true; // Skips chunks hidden behind solid terrain, see ChunkVisibility
+	unsigned int meshArenaSize = 16; // In MB, chunk meshes get sub-allocated out of buffers of this size
 };
@@ -0,0 +1,422 @@
+#include "TerrainGenerator.hpp"
+#include "TTConfig.hpp"
+#include "BlockRegistry.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Terrain shape, heights are in blocks and frequencies in 1 / blocks
+const float TERRAIN_BASE_HEIGHT = 28.0f;
+const float TERRAIN_AMPLITUDE = 18.0f;
+const float TERRAIN_FREQUENCY = 1.0f / 96.0f;
+const unsigned int TERRAIN_OCTAVES = 5;
+const int SAND_HEIGHT = 18; // Surfaces at or below this are sand
+const int SNOW_HEIGHT = 40; // Surfaces at or above this are snow
+const int SOIL_DEPTH = 3; // Blocks of dirt or sand between the surface and the stone
+
+// Caves are the thin shell where the cave noise is close to 0, which gives long winding tunnels
+const float CAVE_FREQUENCY_XZ = 1.0f / 40.0f;
+const float CAVE_FREQUENCY_Y = 1.0f / 24.0f;
+const unsigned int CAVE_OCTAVES = 2;
+const float CAVE_THRESHOLD = 0.07f;
+const uint32_t CAVE_SEED_OFFSET = 0x5BD1E995;
+
+const int DIAMOND_MAX_HEIGHT = 16;
+const uint32_t DIAMOND_RARITY = 400; // About one in this many stone blocks below DIAMOND_MAX_HEIGHT
+
+uint32_t hashPosition(int _x, int _y, int _z, uint32_t _seed){
+	uint32_t h = _seed ^ ((uint32_t)_x * 0x27D4EB2Du) ^ ((uint32_t)_y * 0x165667B1u) ^ ((uint32_t)_z * 0x9E3779B1u);
+	h ^= h >> 15;
+	h *= 0x2C1B3C6Du;
+	h ^= h >> 12;
+	h *= 0x297A2D39u;
+	h ^= h >> 15;
+	return h;
+}
+
+// Maps the low 16 bits of a hash to [-1, 1]
+float hashToFloat(uint32_t _hash){
+	return (float)(_hash & 0xFFFF) * (2.0f / 65535.0f) - 1.0f;
+}
+
+float smoothStep(float _t){
+	return _t * _t * (3.0f - 2.0f * _t);
+}
+
+float lerp(float _a, float _b, float _t){
+	return _a + (_b - _a) * _t;
+}
+
+// Scalar value noise, also the reference the vectorized versions below have to match
+float valueNoise3D(float _x, float _y, float _z, uint32_t _seed){
+	float fx = std::floor(_x);
+	float fy = std::floor(_y);
+	float fz = std::floor(_z);
+	int ix = (int)fx;
+	int iy = (int)fy;
+	int iz = (int)fz;
+	float tx = smoothStep(_x - fx);
+	float ty = smoothStep(_y - fy);
+	float tz = smoothStep(_z - fz);
+
+	float c000 = hashToFloat(hashPosition(ix, iy, iz, _seed));
+	float c100 = hashToFloat(hashPosition(ix + 1, iy, iz, _seed));
+	float c010 = hashToFloat(hashPosition(ix, iy + 1, iz, _seed));
+	float c110 = hashToFloat(hashPosition(ix + 1, iy + 1, iz, _seed));
+	float c001 = hashToFloat(hashPosition(ix, iy, iz + 1, _seed));
+	float c101 = hashToFloat(hashPosition(ix + 1, iy, iz + 1, _seed));
+	float c011 = hashToFloat(hashPosition(ix, iy + 1, iz + 1, _seed));
+	float c111 = hashToFloat(hashPosition(ix + 1, iy + 1, iz + 1, _seed));
+
+	float x00 = lerp(c000, c100, tx);
+	float x10 = lerp(c010, c110, tx);
+	float x01 = lerp(c001, c101, tx);
+	float x11 = lerp(c011, c111, tx);
+	return lerp(lerp(x00, x10, ty), lerp(x01, x11, ty), tz);
+}
+
+float valueNoise2D(float _x, float _z, uint32_t _seed){
+	float fx = std::floor(_x);
+	float fz = std::floor(_z);
+	int ix = (int)fx;
+	int iz = (int)fz;
+	float tx = smoothStep(_x - fx);
+	float tz = smoothStep(_z - fz);
+
+	float c00 = hashToFloat(hashPosition(ix, 0, iz, _seed));
+	float c10 = hashToFloat(hashPosition(ix + 1, 0, iz, _seed));
+	float c01 = hashToFloat(hashPosition(ix, 0, iz + 1, _seed));
+	float c11 = hashToFloat(hashPosition(ix + 1, 0, iz + 1, _seed));
+	return lerp(lerp(c00, c10, tx), lerp(c01, c11, tx), tz);
+}
+
+#ifdef TERRAIN_NOISE_SSE2
+
+// SSE2 has no 32 bit multiply keeping the low halves, so the even and odd lanes are multiplied separately and interleaved again
+__m128i multiply4(__m128i _a, __m128i _b){
+	__m128i even = _mm_mul_epu32(_a, _b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(_a, 32), _mm_srli_epi64(_b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+__m128i hashPosition4(__m128i _x, __m128i _y, __m128i _z, __m128i _seed){
+	__m128i h = _mm_xor_si128(_seed, multiply4(_x, _mm_set1_epi32(0x27D4EB2D)));
+	h = _mm_xor_si128(h, multiply4(_y, _mm_set1_epi32(0x165667B1)));
+	h = _mm_xor_si128(h, multiply4(_z, _mm_set1_epi32((int)0x9E3779B1)));
+	h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+	h = multiply4(h, _mm_set1_epi32(0x2C1B3C6D));
+	h = _mm_xor_si128(h, _mm_srli_epi32(h, 12));
+	h = multiply4(h, _mm_set1_epi32(0x297A2D39));
+	h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+	return h;
+}
+
+__m128 hashToFloat4(__m128i _hash){
+	__m128 low = _mm_cvtepi32_ps(_mm_and_si128(_hash, _mm_set1_epi32(0xFFFF)));
+	return _mm_sub_ps(_mm_mul_ps(low, _mm_set1_ps(2.0f / 65535.0f)), _mm_set1_ps(1.0f));
+}
+
+// SSE2 has no floor either, truncating and then stepping down where that rounded up does the same for the range we use
+__m128i floor4(__m128 _x, __m128& _fraction){
+	__m128i truncated = _mm_cvttps_epi32(_x);
+	__m128 roundedUp = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), _x);
+	__m128i floored = _mm_add_epi32(truncated, _mm_castps_si128(roundedUp));
+	_fraction = _mm_sub_ps(_x, _mm_cvtepi32_ps(floored));
+	return floored;
+}
+
+__m128 smoothStep4(__m128 _t){
+	return _mm_mul_ps(_mm_mul_ps(_t, _t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(_t, _t)));
+}
+
+__m128 lerp4(__m128 _a, __m128 _b, __m128 _t){
+	return _mm_add_ps(_a, _mm_mul_ps(_mm_sub_ps(_b, _a), _t));
+}
+
+void valueNoise2D4(const float* _x, const float* _z, uint32_t _seed, float* _out){
+	__m128 tx, tz;
+	__m128i ix = floor4(_mm_loadu_ps(_x), tx);
+	__m128i iz = floor4(_mm_loadu_ps(_z), tz);
+	tx = smoothStep4(tx);
+	tz = smoothStep4(tz);
+
+	__m128i one = _mm_set1_epi32(1);
+	__m128i zero = _mm_setzero_si128();
+	__m128i seed = _mm_set1_epi32(_seed);
+	__m128i ix1 = _mm_add_epi32(ix, one);
+	__m128i iz1 = _mm_add_epi32(iz, one);
+	__m128 c00 = hashToFloat4(hashPosition4(ix, zero, iz, seed));
+	__m128 c10 = hashToFloat4(hashPosition4(ix1, zero, iz, seed));
+	__m128 c01 = hashToFloat4(hashPosition4(ix, zero, iz1, seed));
+	__m128 c11 = hashToFloat4(hashPosition4(ix1, zero, iz1, seed));
+	_mm_storeu_ps(_out, lerp4(lerp4(c00, c10, tx), lerp4(c01, c11, tx), tz));
+}
+
+void valueNoise3D4(const float* _x, const float* _y, const float* _z, uint32_t _seed, float* _out){
+	__m128 tx, ty, tz;
+	__m128i ix = floor4(_mm_loadu_ps(_x), tx);
+	__m128i iy = floor4(_mm_loadu_ps(_y), ty);
+	__m128i iz = floor4(_mm_loadu_ps(_z), tz);
+	tx = smoothStep4(tx);
+	ty = smoothStep4(ty);
+	tz = smoothStep4(tz);
+
+	__m128i one = _mm_set1_epi32(1);
+	__m128i seed = _mm_set1_epi32(_seed);
+	__m128i ix1 = _mm_add_epi32(ix, one);
+	__m128i iy1 = _mm_add_epi32(iy, one);
+	__m128i iz1 = _mm_add_epi32(iz, one);
+	__m128 x00 = lerp4(hashToFloat4(hashPosition4(ix, iy, iz, seed)), hashToFloat4(hashPosition4(ix1, iy, iz, seed)), tx);
+	__m128 x10 = lerp4(hashToFloat4(hashPosition4(ix, iy1, iz, seed)), hashToFloat4(hashPosition4(ix1, iy1, iz, seed)), tx);
+	__m128 x01 = lerp4(hashToFloat4(hashPosition4(ix, iy, iz1, seed)), hashToFloat4(hashPosition4(ix1, iy, iz1, seed)), tx);
+	__m128 x11 = lerp4(hashToFloat4(hashPosition4(ix, iy1, iz1, seed)), hashToFloat4(hashPosition4(ix1, iy1, iz1, seed)), tx);
+	_mm_storeu_ps(_out, lerp4(lerp4(x00, x10, ty), lerp4(x01, x11, ty), tz));
+}
+
+#else
+
+void valueNoise2D4(const float* _x, const float* _z, uint32_t _seed, float* _out){
+	for(unsigned int i = 0; i < 4; i++){
+		_out[i] = valueNoise2D(_x[i], _z[i], _seed);
+	}
+}
+
+void valueNoise3D4(const float* _x, const float* _y, const float* _z, uint32_t _seed, float* _out){
+	for(unsigned int i = 0; i < 4; i++){
+		_out[i] = valueNoise3D(_x[i], _y[i], _z[i], _seed);
+	}
+}
+
+#endif
+
+// Fractal noise for 4 points at once, each octave doubles the frequency and halves the amplitude. Results are roughly in [-1, 1]
+void fractalNoise2D4(const float* _x, const float* _z, float _frequency, unsigned int _octaves, uint32_t _seed, float* _out){
+	float x[4], z[4], octave[4];
+	float amplitude = 1.0f;
+	float totalAmplitude = 0.0f;
+	for(unsigned int i = 0; i < 4; i++){
+		_out[i] = 0.0f;
+	}
+	for(unsigned int o = 0; o < _octaves; o++){
+		for(unsigned int i = 0; i < 4; i++){
+			x[i] = _x[i] * _frequency;
+			z[i] = _z[i] * _frequency;
+		}
+		// Every octave gets its own seed so the octaves don't line up at the origin
+		valueNoise2D4(x, z, _seed + o, octave);
+		for(unsigned int i = 0; i < 4; i++){
+			_out[i] += octave[i] * amplitude;
+		}
+		totalAmplitude += amplitude;
+		amplitude *= 0.5f;
+		_frequency *= 2.0f;
+	}
+	for(unsigned int i = 0; i < 4; i++){
+		_out[i] /= totalAmplitude;
+	}
+}
+
+void fractalNoise3D4(const float* _x, const float* _y, const float* _z, float _frequencyXZ, float _frequencyY, unsigned int _octaves, uint32_t _seed, float* _out){
+	float x[4], y[4], z[4], octave[4];
+	float amplitude = 1.0f;
+	float totalAmplitude = 0.0f;
+	for(unsigned int i = 0; i < 4; i++){
+		_out[i] = 0.0f;
+	}
+	for(unsigned int o = 0; o < _octaves; o++){
+		for(unsigned int i = 0; i < 4; i++){
+			x[i] = _x[i] * _frequencyXZ;
+			y[i] = _y[i] * _frequencyY;
+			z[i] = _z[i] * _frequencyXZ;
+		}
+		valueNoise3D4(x, y, z, _seed + o, octave);
+		for(unsigned int i = 0; i < 4; i++){
+			_out[i] += octave[i] * amplitude;
+		}
+		totalAmplitude += amplitude;
+		amplitude *= 0.5f;
+		_frequencyXZ *= 2.0f;
+		_frequencyY *= 2.0f;
+	}
+	for(unsigned int i = 0; i < 4; i++){
+		_out[i] /= totalAmplitude;
+	}
+}
+
+void TerrainGenerator::init(uint32_t _seed, unsigned int _numThreads){
+	m_seed = _seed;
+	if(!_numThreads){
+		unsigned int cores = std::thread::hardware_concurrency();
+		_numThreads = cores > 1 ? cores - 1 : 1;
+	}
+
+	m_isRunning = true;
+	for(unsigned int i = 0; i < _numThreads; i++){
+		m_threads.emplace_back(&TerrainGenerator::run, this);
+	}
+}
+
+void TerrainGenerator::destroy(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+		m_requests.clear();
+	}
+	m_requestCondition.notify_all();
+	for(auto& thread : m_threads){
+		thread.join();
+	}
+	m_threads.clear();
+	m_finished.clear();
+}
+
+void TerrainGenerator::generateChunk(int _x, int _y, int _z, BlockStorage& _blocks) const {
+	int cw = CHUNK_WIDTH;
+	int baseX = _x * cw;
+	int baseY = _y * cw;
+	int baseZ = _z * cw;
+
+	// Surface heights for every column of the chunk, 4 columns per noise call
+	int heights[CHUNK_WIDTH * CHUNK_WIDTH];
+	int maxHeight = 0;
+	for(int z = 0; z < cw; z++){
+		for(int x = 0; x < cw; x += 4){
+			float columnX[4] = { (float)(baseX + x), (float)(baseX + x + 1), (float)(baseX + x + 2), (float)(baseX + x + 3) };
+			float columnZ[4] = { (float)(baseZ + z), (float)(baseZ + z), (float)(baseZ + z), (float)(baseZ + z) };
+			float noise[4];
+			fractalNoise2D4(columnX, columnZ, TERRAIN_FREQUENCY, TERRAIN_OCTAVES, m_seed, noise);
+			for(int i = 0; i < 4; i++){
+				int height = (int)(TERRAIN_BASE_HEIGHT + noise[i] * TERRAIN_AMPLITUDE);
+				heights[(z * cw) + x + i] = height;
+				maxHeight = std::max(maxHeight, height);
+			}
+		}
+	}
+
+	// Chunks entirely above the terrain are the most common case when streaming
+	if(baseY > maxHeight){
+		_blocks.fill(BLOCK_AIR);
+		return;
+	}
+
+	std::vector<uint8_t> blocks(CHUNK_SIZE, BLOCK_AIR);
+	for(int y = 0; y < cw; y++){
+		int worldY = baseY + y;
+		for(int z = 0; z < cw; z++){
+			for(int x = 0; x < cw; x += 4){
+				const int* columnHeights = &heights[(z * cw) + x];
+				if(worldY > std::max(std::max(columnHeights[0], columnHeights[1]), std::max(columnHeights[2], columnHeights[3]))){
+					continue;
+				}
+
+				float caveX[4] = { (float)(baseX + x), (float)(baseX + x + 1), (float)(baseX + x + 2), (float)(baseX + x + 3) };
+				float caveY[4] = { (float)worldY, (float)worldY, (float)worldY, (float)worldY };
+				float caveZ[4] = { (float)(baseZ + z), (float)(baseZ + z), (float)(baseZ + z), (float)(baseZ + z) };
+				float cave[4];
+				fractalNoise3D4(caveX, caveY, caveZ, CAVE_FREQUENCY_XZ, CAVE_FREQUENCY_Y, CAVE_OCTAVES, m_seed + CAVE_SEED_OFFSET, cave);
+
+				for(int i = 0; i < 4; i++){
+					int height = columnHeights[i];
+					// The bottom layer is never carved so nothing can fall out of the world
+					if(worldY > height || (worldY > 0 && std::abs(cave[i]) < CAVE_THRESHOLD)){
+						continue;
+					}
+
+					uint8_t block = BLOCK_STONE;
+					if(worldY == height){
+						if(height <= SAND_HEIGHT) block = BLOCK_SAND;
+						else if(height >= SNOW_HEIGHT) block = BLOCK_SNOW;
+						else block = BLOCK_GRASS;
+					}else if(worldY > height - SOIL_DEPTH){
+						block = height <= SAND_HEIGHT ? BLOCK_SAND : BLOCK_DIRT;
+					}else if(worldY < DIAMOND_MAX_HEIGHT && hashPosition(baseX + x + i, worldY, baseZ + z, m_seed) % DIAMOND_RARITY == 0){
+						block = BLOCK_DIAMOND;
+					}
+					blocks[(y * cw * cw) + (z * cw) + x + i] = block;
+				}
+			}
+		}
+	}
+	_blocks.load(blocks.data());
+}
+
+void TerrainGenerator::request(int _x, int _y, int _z){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.emplace_back(_x, _y, _z);
+	}
+	m_requestCondition.notify_one();
+}
+
+void TerrainGenerator::collect(std::vector<GeneratedChunk>& _chunks){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	_chunks.clear();
+	_chunks.swap(m_finished);
+}
+
+void TerrainGenerator::wait(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this](){ return m_requests.empty() && !m_numBusy; });
+}
+
+unsigned int TerrainGenerator::getNumThreads() const {
+	return m_threads.size();
+}
+
+void TerrainGenerator::benchmark(uint32_t _seed, unsigned int _numChunks){
+	unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	int side = (int)std::ceil(std::sqrt(_numChunks / (float)WORLD_HEIGHT));
+	std::vector<GeneratedChunk> chunks;
+
+	std::cout << "TerrainGenerator: Generating " << side * side * WORLD_HEIGHT << " chunks with seed " << _seed << std::endl;
+	for(unsigned int threads = 1; ; threads = std::min(threads * 2, maxThreads)){
+		TerrainGenerator generator;
+		generator.init(_seed, threads);
+
+		auto start = std::chrono::steady_clock::now();
+		for(int z = 0; z < side; z++){
+			for(int x = 0; x < side; x++){
+				for(int y = 0; y < WORLD_HEIGHT; y++){
+					generator.request(x, y, z);
+				}
+			}
+		}
+		generator.wait();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		generator.collect(chunks);
+		generator.destroy();
+
+		std::cout << "TerrainGenerator: " << threads << " threads: " << (unsigned int)(chunks.size() / seconds) << " chunks/s" << std::endl;
+		if(threads == maxThreads) break;
+	}
+}
+
+void TerrainGenerator::run(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(true){
+		m_requestCondition.wait(lock, [this](){ return !m_requests.empty() || !m_isRunning; });
+		if(!m_isRunning) break;
+
+		glm::ivec3 position = m_requests.front();
+		m_requests.pop_front();
+		m_numBusy++;
+		lock.unlock();
+
+		GeneratedChunk chunk;
+		chunk.x = position.x;
+		chunk.y = position.y;
+		chunk.z = position.z;
+		generateChunk(position.x, position.y, position.z, chunk.blocks);
+
+		lock.lock();
+		m_finished.push_back(std::move(chunk));
+		m_numBusy--;
+		if(m_requests.empty() && !m_numBusy) m_doneCondition.notify_all();
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "BlockStorage.hpp"
+#include <glm/glm.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+struct GeneratedChunk {
+	int x, y, z;
+	BlockStorage blocks;
+};
+
+// Generates terrain from a seed: a fractal noise heightmap covered in grass, dirt, sand and snow layers, with caves carved out by 3D noise.
+// A chunk only depends on the seed and its own position, so chunks are generated independently on a pool of worker threads.
+// The noise is evaluated for 4 columns at once with SSE2, other platforms fall back to plain scalar code.
+class TerrainGenerator {
+public:
+
+	// 0 threads uses one per core, minus the one the game runs on
+	void init(uint32_t _seed, unsigned int _numThreads = 0);
+	void destroy();
+
+	// Generates a chunk on the calling thread, safe to call from any thread
+	void generateChunk(int _x, int _y, int _z, BlockStorage& _blocks) const;
+
+	// Asynchronous generation on the worker pool, finished chunks are picked up with collect()
+	void request(int _x, int _y, int _z);
+	void collect(std::vector<GeneratedChunk>& _chunks);
+	// Blocks until every requested chunk is finished
+	void wait();
+	unsigned int getNumThreads() const;
+
+	// Prints how many chunks per second get generated with 1, 2, 4... threads up to the number of cores
+	static void benchmark(uint32_t _seed, unsigned int _numChunks);
+
+private:
+
+	void run();
+
+	uint32_t m_seed = 0;
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_requestCondition; // Signaled when a chunk gets requested or the workers should stop
+	std::condition_variable m_doneCondition; // Signaled when the last busy worker runs out of requests
+	std::deque<glm::ivec3> m_requests;
+	std::vector<GeneratedChunk> m_finished;
+	unsigned int m_numBusy = 0;
+	bool m_isRunning = false;
+
+};
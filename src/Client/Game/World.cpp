@@ -1,448 +1,1137 @@
 #include "World.hpp"
 #include <iostream>
+#include <algorithm>
 #include "FilePathManager.hpp"
 #include "TTConfig.hpp"
+#include "Clock.hpp"
+#include <cstring>
+#include <filesystem>
+#include <bit>
+#include <chrono>
 
-void World::init(TextureArray* _array, BlockTextureHandler* _textureHandler){
-	m_blockTextureHandler = _textureHandler;
+// Streaming budgets, loading and unloading chunks is spread over several frames so it never stalls the game loop
+const unsigned int MAX_CHUNK_LOADS_PER_FRAME = 4;
+const unsigned int MAX_CHUNK_UNLOADS_PER_FRAME = 16;
+const double STREAMING_TIME_BUDGET = 0.002; // In seconds
+
+// Meshing budgets, snapshots and uploads are cheap but there can be hundreds of them after a big edit or a teleport
+const double MESH_TIME_BUDGET = 0.002; // In seconds, for taking snapshots and for uploading, each
+const unsigned int MESHES_IN_FLIGHT_PER_THREAD = 2; // Keeps the workers busy while leaving the rest in the priority queue
+const float OUT_OF_VIEW_PENALTY = 4.0f; // Squared distance multiplier, an out of view chunk counts as twice as far away
+
+const unsigned int NO_ENTRY_FACE = 6; // Entry face of the camera chunk in the occlusion culling walk
+
+// Integer division that rounds towards negative infinity so negative block coordinates map to the right chunk
+int floorDiv(int _a, int _b){
+	return (_a >= 0 ? _a : _a - _b + 1) / _b;
+}
+
+uint64_t getChunkKey(int _x, int _y, int _z){
+	return ((uint64_t)(_x & 0xFFFFFF) << 40) | ((uint64_t)(_z & 0xFFFFFF) << 16) | (uint64_t)(_y & 0xFFFF);
+}
+
+void World::init(TextureArray* _array, Settings* _settings){
 	m_textureArray = _array;
+	m_settings = _settings;
+	m_meshGenerator.init(m_settings->greedyMeshing, m_settings->meshThreads);
+	// Chunks get their ranges out of the chunk buffer, so it has to be ready before the first one is created
+	unsigned int faceStride = m_settings->greedyMeshing ? 2 : 1;
+	m_chunkBuffer.init(faceStride, std::max(1u, m_settings->meshArenaSize) * 1024 * 1024 / (faceStride * sizeof(GLuint)));
+	// Draw time benchmarks have to know which renderer they measured
+	std::string reason = "multiDrawIndirect is turned off in the settings";
+	m_isMultiDrawing = m_settings->multiDrawIndirect && MultiDrawRenderer::isSupported(reason);
+	if(m_isMultiDrawing){
+		m_multiDrawRenderer.init(&m_chunkBuffer);
+		std::cout << "World: Drawing chunks with multi draw indirect" << std::endl;
+	}else{
+		std::cout << "World: Drawing chunks one by one because " << reason << std::endl;
+	}
 	unsigned int ww = WORLD_WIDTH;
 	unsigned int wl = WORLD_LENGTH;
 	unsigned int wh = WORLD_HEIGHT;
-	unsigned int cw = CHUNK_WIDTH;
-	
-	m_data_length = ww * wl * wh * cw * cw * cw;
-	m_data = static_cast<uint8_t*>(malloc(m_data_length));
-
-	unsigned int maxW = ww * cw;
-	unsigned int maxL = wl * cw;
-
-	// Fill in the memory
-	for(unsigned int y = 0; y < wh * cw; y++){
-		for(unsigned int z = 0; z < wl * cw; z++){
-			for(unsigned int x = 0; x < ww * cw; x++){
-				if(y < 20){
-					m_data[(y * maxW * maxL) + (z * maxW) + x] = 5;
-				}else if(x == z){
-					m_data[(y * maxW * maxL) + (z * maxW) + x] = 2;
-				}else{
-					m_data[(y * maxW * maxL) + (z * maxW) + x] = 0;
+
+	// Worlds are stored as region files, the legacy lobby file gets converted the first time we run
+	std::string folder = FilePathManager::getRootFolderDirectory() + "world/";
+	if(!std::filesystem::exists(folder)){
+		if(RegionStorage::convertLegacyWorld(FilePathManager::getRootFolderDirectory() + "lobby.dat", folder)){
+			std::cout << "World: Converted lobby.dat to region files in " << folder << std::endl;
+		}
+	}
+	m_meshSubscriber = m_changeFeed.subscribe();
+	m_saveSubscriber = m_changeFeed.subscribe();
+	m_regionStorage.init(folder, m_settings->mmapWorld);
+	m_worldSaver.init(&m_regionStorage);
+	m_terrainGenerator.init(m_settings->worldSeed, m_settings->generatorThreads);
+	m_autosaveTimer.restart();
+	m_worldClock.restart();
+
+	// When streaming, chunks get loaded around the player in update()
+	if(!m_settings->streamWorld){
+		// Initializing the m_chunks
+		for(unsigned int y = 0; y < wh; y++){
+			for(unsigned int z = 0; z < wl; z++){
+				for(unsigned int x = 0; x < ww; x++){
+					loadChunk(x, y, z);
 				}
 			}
 		}
+		// Whatever isn't stored yet gets generated in parallel, but the world has to be complete before the game starts
+		m_terrainGenerator.wait();
+		addGeneratedChunks();
+
+		unsigned int flatSize = ww * wl * wh * CHUNK_SIZE;
+		std::cout << "World: Block storage uses " << getBlockMemoryUsage() / 1024 << " KB (" << flatSize / 1024 << " KB as a flat array)" << std::endl;
 	}
 
-	loadWorldFromFile(FilePathManager::getRootFolderDirectory() + "lobby.dat");
+	// Initializing the m_shaders, the cutout one is the same shader with the alpha test compiled in.
+	// Multi draw reads the chunk origins from a storage buffer, which needs a newer GLSL version
+	for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+		std::vector<std::string> defines;
+		if(pass == CHUNK_PASS_CUTOUT) defines.push_back("CUTOUT");
+		if(m_isMultiDrawing) defines.push_back("MULTI_DRAW");
+		m_shaders[pass].load("chunk", defines, m_isMultiDrawing ? "430 core" : "");
+		if(!m_isMultiDrawing) m_chunkPositionUniforms[pass] = m_shaders[pass].getUniform<glm::vec3>("chunkPosition");
+		m_greedyMeshingUniforms[pass] = m_shaders[pass].getUniform<bool>("greedyMeshing");
+	}
+}
 
-	// Initializing the m_chunks
-	m_chunks = new Chunk[ww * wl * wh];
-	for(unsigned int y = 0; y < wh; y++){
-		for(unsigned int z = 0; z < wl; z++){
-			for(unsigned int x = 0; x < ww; x++){
-				getChunk(x, y, z)->init(x * cw, y * cw, z * cw);
-			}
-		}
+unsigned int World::getBlockMemoryUsage() const {
+	unsigned int total = 0;
+	for(auto& it : m_chunks){
+		total += it.second->blocks.getMemoryUsage();
 	}
+	return total;
+}
 
-	// Initializing the m_shader
-	m_shader.load("chunk");
+unsigned int World::getNumLoadedChunks() const {
+	return m_chunks.size();
 }
 
-GLuint World::packData(uint8_t x, uint8_t y, uint8_t z, uint8_t lightLevel, uint8_t textureCoordinateIndex, uint16_t textureArrayIndex) {
-	GLuint vertex = x | y << 6 | z << 12 | lightLevel << 18 | textureCoordinateIndex << 21 | textureArrayIndex << 23;
-	return vertex;
+unsigned int World::getNumFaces() const {
+	unsigned int total = 0;
+	for(auto& it : m_chunks){
+		total += it.second->getNumFaces();
+	}
+	return total;
 }
 
-void World::render(Camera& _camera){
-	m_shader.bind();
+unsigned int World::getMeshMemoryUsage() const {
+	unsigned int total = 0;
+	for(auto& it : m_chunks){
+		total += it.second->getMeshMemoryUsage();
+	}
+	return total;
+}
 
-	m_textureArray->bind();
+ChunkBufferStats World::getMeshBufferStats() const {
+	return m_chunkBuffer.getStats();
+}
 
-	m_shader.loadUniform("projection", _camera.getProjectionMatrix());
-	m_shader.loadUniform("view", _camera.getViewMatrix());
-	m_shader.loadUniform("cameraPosition", _camera.getPosition());
+double World::getLastDrawTime() const {
+	return m_lastDrawTime * 1000.0;
+}
 
-	unsigned int ww = WORLD_WIDTH;
-	unsigned int wl = WORLD_LENGTH;
-	unsigned int wh = WORLD_HEIGHT;
+bool World::isMultiDrawing() const {
+	return m_isMultiDrawing;
+}
 
-	for(unsigned int y = 0; y < wh; y++){
-		for(unsigned int z = 0; z < wl; z++){
-			for(unsigned int x = 0; x < ww; x++){
-				Chunk* c = getChunk(x, y, z);
+unsigned int World::getNumChunksDrawn() const {
+	return m_numChunksDrawn;
+}
 
-				if(c->needsVaoUpdate){ // Generate mesh if chunk needs mesh update
-					c->pushData();
-					c->needsVaoUpdate = false;
-				}
-				if(c->getNumVertices()){ // Render only if chunk has vertices
-					m_shader.loadUniform("chunkPosition", glm::vec3(c->x, c->y, c->z));
-					c->render();
-				}
-			}
-		}
+unsigned int World::getNumChunksCulled() const {
+	return m_numChunksCulled;
+}
+
+unsigned int World::getNumChunksOccluded() const {
+	return m_numChunksOccluded;
+}
+
+double World::getAverageMeshTime() const {
+	return m_meshGenerator.getAverageMeshTime();
+}
+
+unsigned int World::getNumMeshesPending() const {
+	return m_meshGenerator.getNumPending();
+}
+
+double World::getLastEditLatency() const {
+	return m_lastEditLatency * 1000.0;
+}
+
+double World::getAverageEditLatency() const {
+	if(!m_numEditLatencies) return 0.0;
+	return m_totalEditLatency * 1000.0 / m_numEditLatencies;
+}
+
+bool World::isGreedyMeshing() const {
+	return m_settings->greedyMeshing;
+}
+
+void World::update(const glm::vec3& _playerPosition){
+	addGeneratedChunks();
+
+	// Autosaving only snapshots the edited chunks, the writing happens on the saver thread
+	if(m_settings->autosaveInterval > 0 && m_autosaveTimer.getElapsedTime() >= m_settings->autosaveInterval){
+		saveWorld();
+		m_autosaveTimer.restart();
 	}
 
-	m_textureArray->unbind();
+	if(!m_settings->streamWorld) return;
+
+	int cw = CHUNK_WIDTH;
+	glm::ivec3 center(floorDiv((int)glm::floor(_playerPosition.x), cw), 0, floorDiv((int)glm::floor(_playerPosition.z), cw));
+
+	// The queues only need rebuilding when the player crosses a chunk border
+	if(!m_hasStreamingCenter || center != m_streamingCenter){
+		m_streamingCenter = center;
+		m_hasStreamingCenter = true;
+		queueChunkStreaming();
+	}
+
+	Clock budget;
+	budget.restart();
+
+	unsigned int unloads = 0;
+	while(!m_chunksToUnload.empty() && unloads < MAX_CHUNK_UNLOADS_PER_FRAME && budget.getElapsedTime() < STREAMING_TIME_BUDGET){
+		glm::ivec3 pos = m_chunksToUnload.back();
+		m_chunksToUnload.pop_back();
+		if(!isChunkInRenderDistance(pos.x, pos.z, 1)){
+			destroyChunk(pos.x, pos.y, pos.z);
+			unloads++;
+		}
+	}
 
-	m_shader.unbind();
+	unsigned int loads = 0;
+	while(!m_chunksToLoad.empty() && loads < MAX_CHUNK_LOADS_PER_FRAME && budget.getElapsedTime() < STREAMING_TIME_BUDGET){
+		glm::ivec3 pos = m_chunksToLoad.back();
+		m_chunksToLoad.pop_back();
+		if(isChunkInRenderDistance(pos.x, pos.z, 0) && !getChunk(pos.x, pos.y, pos.z)){
+			loadChunk(pos.x, pos.y, pos.z);
+			loads++;
+		}
+	}
 }
 
-void World::destroy(){
-	unsigned int ww = WORLD_WIDTH;
-	unsigned int wl = WORLD_LENGTH;
-	unsigned int wh = WORLD_HEIGHT;
+void World::queueChunkStreaming(){
+	int rd = m_settings->renderDistance;
+	int wh = WORLD_HEIGHT;
 
-	for(unsigned int y = 0; y < wh; y++){
-		for(unsigned int z = 0; z < wl; z++){
-			for(unsigned int x = 0; x < ww; x++){
-				getChunk(x, y, z)->destroy();
+	m_chunksToLoad.clear();
+	for(int z = m_streamingCenter.z - rd; z <= m_streamingCenter.z + rd; z++){
+		for(int x = m_streamingCenter.x - rd; x <= m_streamingCenter.x + rd; x++){
+			if(!isChunkInRenderDistance(x, z, 0)) continue;
+			for(int y = 0; y < wh; y++){
+				if(!getChunk(x, y, z)) m_chunksToLoad.emplace_back(x, y, z);
 			}
 		}
 	}
-	m_shader.destroy();
-	delete[] m_chunks;
-	free(m_data);
+
+	// Sorting the farthest chunks to the front so the closest ones can be popped off the back first
+	glm::ivec3 center = m_streamingCenter;
+	std::sort(m_chunksToLoad.begin(), m_chunksToLoad.end(), [center](const glm::ivec3& a, const glm::ivec3& b){
+		int da = (a.x - center.x) * (a.x - center.x) + (a.z - center.z) * (a.z - center.z);
+		int db = (b.x - center.x) * (b.x - center.x) + (b.z - center.z) * (b.z - center.z);
+		return da > db;
+	});
+
+	// We keep an extra ring of chunks loaded so walking back and forth over a chunk border doesn't thrash
+	m_chunksToUnload.clear();
+	for(auto& it : m_chunks){
+		Chunk* c = it.second;
+		int x = floorDiv(c->x, CHUNK_WIDTH);
+		int y = floorDiv(c->y, CHUNK_WIDTH);
+		int z = floorDiv(c->z, CHUNK_WIDTH);
+		if(!isChunkInRenderDistance(x, z, 1)) m_chunksToUnload.emplace_back(x, y, z);
+	}
 }
 
-void World::loadWorldFromFile(const std::string& path) {
-	std::ifstream file(path, std::ios::in | std::ios::binary);
-	if (!file.good()) {
-		std::cout << "World: Could not open file: " << path << std::endl;
+bool World::isChunkInRenderDistance(int _x, int _z, int _margin){
+	int rd = m_settings->renderDistance + _margin;
+	int dx = _x - m_streamingCenter.x;
+	int dz = _z - m_streamingCenter.z;
+	return dx * dx + dz * dz <= rd * rd;
+}
+
+Chunk* World::createChunk(int _x, int _y, int _z){
+	unsigned int cw = CHUNK_WIDTH;
+
+	Chunk* c = new Chunk;
+	c->init(_x * cw, _y * cw, _z * cw, &m_chunkBuffer);
+	// Meshes still in flight for a chunk that used to be here must not end up in this one
+	for(auto& section : c->sections){
+		section.meshID = m_nextMeshID;
+	}
+	m_chunks[getChunkKey(_x, _y, _z)] = c;
+	return c;
+}
+
+void World::loadChunk(int _x, int _y, int _z){
+	uint64_t key = getChunkKey(_x, _y, _z);
+	if(m_chunksGenerating.count(key)){
 		return;
 	}
-	for (int i = 0; i < m_data_length; i++) {
-		file.read((char*)&m_data[i], sizeof(uint8_t));
+
+	BlockStorage blocks;
+	if(m_worldSaver.getPending(_x, _y, _z, blocks) || m_regionStorage.loadChunk(_x, _y, _z, blocks)){
+		addChunk(_x, _y, _z, blocks);
+		return;
 	}
-	file.close();
+
+	// Chunks that were never saved get generated on the worker threads and added once they're done
+	m_chunksGenerating.insert(key);
+	m_terrainGenerator.request(_x, _y, _z);
 }
 
-void World::saveWorldToFile(const std::string& path) {
-	std::ofstream file(path, std::ios::out | std::ios::binary);
-	if (!file.good()) {
-		std::cerr << "could not open " << path << " file for writing" << std::endl;
-		return;
+void World::addGeneratedChunks(){
+	m_terrainGenerator.collect(m_generatedChunks);
+	for(auto& generated : m_generatedChunks){
+		m_chunksGenerating.erase(getChunkKey(generated.x, generated.y, generated.z));
+		// The player may have moved on while the chunk was being generated
+		if(m_settings->streamWorld && !isChunkInRenderDistance(generated.x, generated.z, 0)){
+			continue;
+		}
+		if(!getChunk(generated.x, generated.y, generated.z)){
+			addChunk(generated.x, generated.y, generated.z, generated.blocks);
+		}
 	}
-	for (int i = 0; i < m_data_length; i++) {
-		file.write((char*)&m_data[i], sizeof(uint8_t));
+	m_generatedChunks.clear();
+}
+
+void World::addChunk(int _x, int _y, int _z, BlockStorage& _blocks){
+	Chunk* c = createChunk(_x, _y, _z);
+	c->blocks = std::move(_blocks);
+	c->updateHeightmap();
+	m_regionStorage.retainChunk(_x, _y, _z);
+	m_changeFeed.publish({ glm::ivec3(_x, _y, _z), c->version, ChunkChangeType::LOADED });
+}
+
+void World::destroyChunk(int _x, int _y, int _z){
+	auto it = m_chunks.find(getChunkKey(_x, _y, _z));
+	if(it == m_chunks.end()) return;
+
+	if(it->second->needsSave){
+		m_worldSaver.queue(_x, _y, _z, it->second->blocks);
+	}
+	// A queued save reopens the region if it got closed in the meantime
+	m_regionStorage.releaseChunk(_x, _y, _z);
+	if(m_cachedChunk == it->second) m_cachedChunk = nullptr;
+	m_changeFeed.publish({ glm::ivec3(_x, _y, _z), it->second->version, ChunkChangeType::UNLOADED });
+	it->second->destroy();
+	delete it->second;
+	m_chunks.erase(it);
+}
+
+void World::publishEdit(Chunk* _c, const glm::ivec3& _low, const glm::ivec3& _high, bool _byPlayer){
+	int cw = CHUNK_WIDTH;
+
+	_c->version++;
+	_c->needsSave = true;
+	// Edits made before the chunk got remeshed end up in the same mesh, so we time the oldest one
+	if(_byPlayer && _c->playerEditTime < 0.0){
+		_c->playerEditTime = m_worldClock.getElapsedTime();
+		_c->playerEditMeshID = 0;
 	}
-	file.close();
-	if(!file.good()) {
-      	std::cerr << "Error occurred at writing time!" << std::endl;
+
+	ChunkChange change;
+	change.position = glm::ivec3(floorDiv(_c->x, cw), floorDiv(_c->y, cw), floorDiv(_c->z, cw));
+	change.version = _c->version;
+	change.type = ChunkChangeType::EDITED;
+	change.min = _low;
+	change.max = _high;
+	change.isPlayerEdit = _byPlayer;
+	// Blocks on the edge of the chunk are visible from the neighbouring chunks too
+	if(_low.x == 0) change.borders |= CHUNK_BORDER_LEFT;
+	if(_high.x == cw - 1) change.borders |= CHUNK_BORDER_RIGHT;
+	if(_low.y == 0) change.borders |= CHUNK_BORDER_BOTTOM;
+	if(_high.y == cw - 1) change.borders |= CHUNK_BORDER_TOP;
+	if(_low.z == 0) change.borders |= CHUNK_BORDER_BACK;
+	if(_high.z == cw - 1) change.borders |= CHUNK_BORDER_FRONT;
+	m_changeFeed.publish(change);
+}
+
+void World::queueMeshUpdate(int _x, int _y, int _z, uint64_t _sections, bool _isUrgent){
+	Chunk* c = getChunk(_x, _y, _z);
+	if(!c){
 		return;
-  	}
+	}
+	c->dirtySections |= _sections;
+	if(!c->needsMeshUpdate){
+		c->needsMeshUpdate = true;
+		m_chunksToMesh.emplace_back(_x, _y, _z);
+	}
+	c->isMeshUrgent |= _isUrgent;
 }
 
-void World::updateMeshes(){
-	unsigned int ww = WORLD_WIDTH;
-	unsigned int wl = WORLD_LENGTH;
-	unsigned int wh = WORLD_HEIGHT;
+float World::getMeshPriority(Chunk* _chunk, const Camera& _camera){
+	// Player edits always come first, among them the closest one
+	glm::vec3 center = glm::vec3(_chunk->x, _chunk->y, _chunk->z) + glm::vec3(CHUNK_WIDTH * 0.5f);
+	float distance = glm::distance(center, _camera.getPosition());
+	if(_chunk->isMeshUrgent){
+		return distance - 1000000.0f;
+	}
 
-	for(unsigned int y = 0; y < wh; y++){
-		for(unsigned int z = 0; z < wl; z++){
-			for(unsigned int x = 0; x < ww; x++){
-				Chunk* c = getChunk(x, y, z);
+	// In view means the same as for frustum culling in render(), tested right away since the chunk may not have been rendered yet
+	bool isInView = _camera.getFrustum().isCubeVisible(glm::vec3(_chunk->x, _chunk->y, _chunk->z), CHUNK_WIDTH);
+	return isInView ? distance * distance : distance * distance * OUT_OF_VIEW_PENALTY;
+}
 
-				if(c->needsMeshUpdate){ // Generate mesh if chunk needs mesh update
-					generateMesh(c);
-					c->needsMeshUpdate = false;
-					c->needsVaoUpdate = true;
-				}
+void World::uploadMesh(Chunk* _chunk){
+	_chunk->pushData();
+	_chunk->needsVaoUpdate = false;
+
+	// The player's edit is on screen from the next draw on, once every section of the request that included it is
+	bool isEditVisible = _chunk->playerEditTime >= 0.0 && _chunk->playerEditMeshID;
+	uint64_t sections = _chunk->playerEditSections;
+	while(isEditVisible && sections){
+		unsigned int i = std::countr_zero(sections);
+		sections &= sections - 1;
+		isEditVisible = _chunk->sections[i].meshID >= _chunk->playerEditMeshID;
+	}
+	if(isEditVisible){
+		m_lastEditLatency = m_worldClock.getElapsedTime() - _chunk->playerEditTime;
+		m_totalEditLatency += m_lastEditLatency;
+		m_numEditLatencies++;
+		_chunk->playerEditTime = -1.0;
+		_chunk->playerEditMeshID = 0;
+	}
+}
+
+ChunkChangeFeed& World::getChangeFeed(){
+	return m_changeFeed;
+}
+
+void World::render(Camera& _camera){
+	// Whatever doesn't fit in the budget gets uploaded next frame, but at least one upload always happens
+	Clock budget;
+	budget.restart();
+	unsigned int numUploaded = 0;
+	while(numUploaded < m_chunksToUpload.size() && (!numUploaded || budget.getElapsedTime() < MESH_TIME_BUDGET)){
+		glm::ivec3 position = m_chunksToUpload[numUploaded++];
+		Chunk* c = getChunk(position.x, position.y, position.z);
+		if(c && c->needsVaoUpdate){
+			uploadMesh(c);
+		}
+	}
+	m_chunksToUpload.erase(m_chunksToUpload.begin(), m_chunksToUpload.begin() + numUploaded);
+
+	// Every chunk gets tested against the view frustum at once, the empty ones too since occlusion culling walks through them
+	m_cullChunks.resize(0);
+	m_cullX.resize(0);
+	m_cullY.resize(0);
+	m_cullZ.resize(0);
+	for(auto& it : m_chunks){
+		Chunk* c = it.second;
+		m_cullChunks.push_back(c);
+		m_cullX.push_back(c->x);
+		m_cullY.push_back(c->y);
+		m_cullZ.push_back(c->z);
+	}
+	m_cullVisible.resize(m_cullChunks.size());
+	_camera.getFrustum().cullCubes(m_cullX.data(), m_cullY.data(), m_cullZ.data(), m_cullChunks.size(), CHUNK_WIDTH, m_cullVisible.data());
+	unsigned int numWithFaces = 0;
+	unsigned int numInFrustum = 0;
+	for(unsigned int i = 0; i < m_cullChunks.size(); i++){
+		Chunk* c = m_cullChunks[i];
+		c->isInFrustum = m_cullVisible[i];
+		c->enteredFaces = 0;
+		if(c->getNumFaces()){
+			numWithFaces++;
+			numInFrustum += c->isInFrustum;
+		}
+	}
+
+	// Only the chunks that can be seen from the camera chunk through the ones in between get drawn. Without a
+	// camera chunk, like above the world, there's nothing to start from and every chunk in view is drawn
+	m_chunksToRender.resize(0);
+	glm::ivec3 cameraChunk(glm::floor(_camera.getPosition() / (float)CHUNK_WIDTH));
+	Chunk* start = m_settings->occlusionCulling ? getChunk(cameraChunk.x, cameraChunk.y, cameraChunk.z) : nullptr;
+	if(start){
+		findUnoccludedChunks(start);
+	} else {
+		for(Chunk* c : m_cullChunks){
+			if(c->isInFrustum && c->getNumFaces()){
+				m_chunksToRender.push_back(c);
 			}
 		}
 	}
-}
+	m_numChunksCulled = numWithFaces - numInFrustum;
+	m_numChunksOccluded = numInFrustum - m_chunksToRender.size();
+	m_numChunksDrawn = m_chunksToRender.size();
 
-void World::generateMesh(Chunk* _chunk){
-	_chunk->vertices.resize(0);
-	unsigned int cw = CHUNK_WIDTH;
+	Clock drawTimer;
+	drawTimer.restart();
+	m_textureArray->bind();
 
-	for(unsigned int y = 0; y < cw; y++){
-		for(unsigned int z = 0; z < cw; z++){
-			for(unsigned int x = 0; x < cw; x++){
-				uint8_t block = getBlock(_chunk->x + x, _chunk->y + y, _chunk->z + z);
+	// Opaque faces go first so they fill the depth buffer before the cutout pass, which is the only one that discards
+	for(unsigned int pass = 0; pass < NUM_CHUNK_PASSES; pass++){
+		Shader& shader = m_shaders[pass];
+		shader.bind();
+		shader.loadUniform(m_greedyMeshingUniforms[pass], m_settings->greedyMeshing);
 
-				if(block){
-					addBlock(_chunk, x, y, z, block);
+		if(m_isMultiDrawing){
+			m_multiDrawRenderer.render(m_chunksToRender, pass);
+		} else {
+			for(Chunk* c : m_chunksToRender){
+				if(c->getNumFaces(pass)){ // Render only if chunk has faces in this pass
+					shader.loadUniform(m_chunkPositionUniforms[pass], glm::vec3(c->x, c->y, c->z));
+					c->render(pass);
 				}
 			}
 		}
+		shader.unbind();
 	}
+
+	m_textureArray->unbind();
+	m_lastDrawTime = drawTimer.getElapsedTime();
 }
 
-bool World::isBlockInLocalWorld(int _x, int _y, int _z){
-	unsigned int maxW = WORLD_WIDTH * CHUNK_WIDTH;
-	unsigned int maxL = WORLD_LENGTH * CHUNK_WIDTH;
-	unsigned int maxH = WORLD_HEIGHT * CHUNK_WIDTH;
+void World::findUnoccludedChunks(Chunk* _start){
+	int cw = CHUNK_WIDTH;
 
-	if(_x < 0 || _x >= maxW || _z < 0 || _z >= maxL || _y < 0 || _y >= maxH) return false;
-	return true;
+	// A breadth first walk from the camera chunk. Going from one chunk into the next needs the face it was entered
+	// through to be connected to the face it's left through. The walk never turns back towards the camera, a step in a
+	// direction opposite to one it has taken before can only lead to what's hidden behind what it came through.
+	// A chunk can be entered through every face once, the first way into it doesn't have to be the one that sees the most
+	m_occlusionQueue.resize(0);
+	m_occlusionQueue.push_back({ _start, NO_ENTRY_FACE, 0 });
+	_start->enteredFaces = 0x3F;
+	if(_start->isInFrustum && _start->getNumFaces()){
+		m_chunksToRender.push_back(_start);
+	}
+	for(size_t i = 0; i < m_occlusionQueue.size(); i++){
+		OcclusionStep step = m_occlusionQueue[i];
+		Chunk* c = step.chunk;
+		for(unsigned int face = 0; face < 6; face++){
+			unsigned int entry = getOppositeFace(face);
+			if(step.directions & (1 << entry)){
+				continue;
+			}
+			if(step.entryFace != NO_ENTRY_FACE && !ChunkVisibility::isConnected(c->visibility, step.entryFace, face)){
+				continue;
+			}
+			// Chunks out of view can't be on a line of sight, so the walk doesn't need to go through them
+			Chunk* next = getChunk((c->x / cw) + FACE_OFFSETS[face][0], (c->y / cw) + FACE_OFFSETS[face][1], (c->z / cw) + FACE_OFFSETS[face][2]);
+			if(!next || !next->isInFrustum || (next->enteredFaces & (1 << entry))){
+				continue;
+			}
+			if(!next->enteredFaces && next->getNumFaces()){
+				m_chunksToRender.push_back(next);
+			}
+			next->enteredFaces |= 1 << entry;
+			m_occlusionQueue.push_back({ next, entry, (uint8_t)(step.directions | (1 << face)) });
+		}
+	}
 }
 
-uint8_t World::getBlock(int _x, int _y, int _z){
-	if(!isBlockInLocalWorld(_x, _y, _z)){
-		return 0;
-	}
+void World::destroy(){
+	m_terrainGenerator.destroy();
+	m_chunksGenerating.clear();
+	// Mesh snapshots can point into the mapped region files
+	m_meshGenerator.destroy();
+	m_meshResults.clear();
+	m_numMeshesInFlight = 0;
 
-	unsigned int maxW = WORLD_WIDTH * CHUNK_WIDTH;
-	unsigned int maxL = WORLD_LENGTH * CHUNK_WIDTH;
+	// The saver has to be done with the region files before they get closed
+	saveWorld();
+	m_worldSaver.destroy();
+	m_regionStorage.destroy();
 
-	return m_data[(_y * maxW * maxL) + (_z * maxW) + _x];
+	// What the arenas looked like at the end, for tuning meshArenaSize
+	ChunkBufferStats stats = m_chunkBuffer.getStats();
+	std::cout << "World: Mesh arenas " << stats.numArenas << " x " << m_settings->meshArenaSize << " MB, " << (int)(stats.getUtilisation() * 100.0f) << "% used, ";
+	std::cout << (int)(stats.getFragmentation() * 100.0f) << "% of the free space fragmented over " << stats.numFreeRanges << " ranges" << std::endl;
+	for(auto& it : m_chunks){
+		it.second->destroy();
+		delete it.second;
+	}
+	m_chunks.clear();
+	m_cachedChunk = nullptr;
+	m_chunksToRender.clear();
+	if(m_isMultiDrawing){
+		m_multiDrawRenderer.destroy();
+	}
+	m_chunkBuffer.destroy();
+	m_chunksToMesh.clear();
+	m_chunksToUpload.clear();
+	m_changeFeed.unsubscribe(m_meshSubscriber);
+	m_changeFeed.unsubscribe(m_saveSubscriber);
+	for(auto& shader : m_shaders){
+		shader.destroy();
+	}
 }
 
-void World::setBlock(int x, int y, int z, uint8_t block) {
-	if(!isBlockInLocalWorld(x, y, z)){
-		return;
+void World::saveWorld(){
+	// Only chunks edited since the last save get queued, and queueing one doesn't copy its blocks.
+	// Unloaded chunks were already queued by destroyChunk
+	m_changes.clear();
+	m_changeFeed.poll(m_saveSubscriber, m_changes);
+	for(auto& change : m_changes){
+		if(change.type != ChunkChangeType::EDITED){
+			continue;
+		}
+		Chunk* c = getChunk(change.position.x, change.position.y, change.position.z);
+		if(c && c->needsSave){
+			m_worldSaver.queue(change.position.x, change.position.y, change.position.z, c->blocks);
+			c->needsSave = false;
+		}
 	}
+}
 
-	unsigned int ww = WORLD_WIDTH;
-	unsigned int wl = WORLD_LENGTH;
-	unsigned int wh = WORLD_HEIGHT;
-	unsigned int cw = CHUNK_WIDTH;
+void World::updateMeshes(const Camera& _camera){
+	// Working out which meshes went stale from what changed since last frame, instead of checking every chunk
+	m_changes.clear();
+	m_changeFeed.poll(m_meshSubscriber, m_changes);
+	int cw = CHUNK_WIDTH;
+	for(auto& change : m_changes){
+		glm::ivec3 p = change.position;
+		bool isUrgent = change.isPlayerEdit;
 
-	unsigned int maxW = ww * cw;
-	unsigned int maxL = wl * cw;
+		// The faces of a block depend on every block around it, so the sections within one block of the change need remeshing.
+		// Only the sections along the border of a neighbouring chunk can be that close
+		for(int dy = -1; dy <= 1; dy++){
+			for(int dz = -1; dz <= 1; dz++){
+				for(int dx = -1; dx <= 1; dx++){
+					if(!dx && !dy && !dz && change.type == ChunkChangeType::UNLOADED){
+						continue;
+					}
+					glm::ivec3 offset = glm::ivec3(dx, dy, dz) * cw;
+					glm::ivec3 low = glm::max(change.min - 1 - offset, glm::ivec3(0));
+					glm::ivec3 high = glm::min(change.max + 1 - offset, glm::ivec3(cw - 1));
+					if(low.x <= high.x && low.y <= high.y && low.z <= high.z){
+						queueMeshUpdate(p.x + dx, p.y + dy, p.z + dz, ChunkMesher::getSectionMask(&low[0], &high[0]), isUrgent);
+					}
+				}
+			}
+		}
+	}
 
-	// Getting the chunk the block is in
-	unsigned int posX = x / cw;
-	unsigned int posY = y / cw;
-	unsigned int posZ = z / cw;
+	// The workers did the meshing, all that's left here is handing the faces over for upload
+	m_meshGenerator.collect(m_meshResults);
+	m_numMeshesInFlight -= m_meshResults.size();
+	for(auto& result : m_meshResults){
+		Chunk* c = getChunk(result.position.x, result.position.y, result.position.z);
+		if(!c){
+			continue;
+		}
+		// Meshes finish out of order, so sections older than what the chunk already shows are dropped
+		bool isNewer = false;
+		uint64_t sections = result.sections;
+		while(sections){
+			unsigned int i = std::countr_zero(sections);
+			sections &= sections - 1;
+			ChunkSection& section = c->sections[i];
+			if(result.id <= section.meshID){
+				continue;
+			}
+			std::swap(section.mesh, result.meshes[i]);
+			section.meshID = result.id;
+			section.needsUpload = true;
+			isNewer = true;
+		}
+		if(isNewer){
+			queueVaoUpdate(c, result.position);
+		}
+		if(result.id > c->visibilityMeshID){
+			c->visibility = result.visibility;
+			c->visibilityMeshID = result.id;
+		}
+	}
+	m_meshResults.clear();
 
-	// Right now, we have the position of the chunk that the block has been placed in stored in posX, posY, and posZ
-	// So we first of all, queue this chunk up for a mesh update
-	getChunk(posX, posY, posZ)->needsMeshUpdate = true;
+	if(m_chunksToMesh.empty()){
+		return;
+	}
 
-	// Setting the block based on chunk space coords
-	m_data[(y * maxW * maxL) + (z * maxW) + x] = block;
+	// The priorities change as the camera moves, so the queue gets sorted again every frame
+	m_meshQueue.clear();
+	for(auto& position : m_chunksToMesh){
+		Chunk* c = getChunk(position.x, position.y, position.z);
+		if(c && c->needsMeshUpdate){ // Otherwise it got unloaded since it was queued
+			m_meshQueue.emplace_back(getMeshPriority(c, _camera), position);
+		}
+	}
+	std::sort(m_meshQueue.begin(), m_meshQueue.end(), [](const auto& a, const auto& b){ return a.first < b.first; });
 
-	// Next, we check if the placed block has been placed on any edge
-	// Update neighboring m_chunks if block is on the edge of the current chunk
-	if(x % cw == 0){
-		Chunk* chunk = getChunk((posX - 1) % ww, posY, posZ);
-		if(chunk) chunk->needsMeshUpdate = true;
+	// Only a few meshes per worker get handed over at a time, so a chunk queued later can still overtake the rest.
+	// Player edits skip that limit
+	unsigned int maxInFlight = m_meshGenerator.getNumThreads() * MESHES_IN_FLIGHT_PER_THREAD;
+	Clock budget;
+	budget.restart();
+	unsigned int numHandled = 0;
+	for(auto& queued : m_meshQueue){
+		Chunk* c = getChunk(queued.second.x, queued.second.y, queued.second.z);
+		if(!c->needsMeshUpdate){ // A chunk that got reloaded can be queued twice
+			numHandled++;
+			continue;
+		}
+		if(!c->isMeshUrgent && (m_numMeshesInFlight >= maxInFlight || budget.getElapsedTime() >= MESH_TIME_BUDGET)){
+			break;
+		}
+		requestMesh(c, queued.second);
+		c->needsMeshUpdate = false;
+		c->isMeshUrgent = false;
+		numHandled++;
 	}
-	if((x + 1) % cw == 0){
-		Chunk* chunk = getChunk((posX + 1) % ww, posY, posZ);
-		if(chunk) chunk->needsMeshUpdate = true;
+
+	m_chunksToMesh.clear();
+	for(unsigned int i = numHandled; i < m_meshQueue.size(); i++){
+		m_chunksToMesh.push_back(m_meshQueue[i].second);
 	}
-	if(z % cw == 0){
-		Chunk* chunk = getChunk(posX, posY, (posZ - 1) % wl);
-		if(chunk) chunk->needsMeshUpdate = true;
+}
+
+void World::requestMesh(Chunk* _chunk, const glm::ivec3& _position){
+	uint64_t id = ++m_nextMeshID;
+	uint64_t sections = _chunk->dirtySections;
+	_chunk->dirtySections = 0;
+	if(_chunk->playerEditTime >= 0.0 && !_chunk->playerEditMeshID){
+		_chunk->playerEditMeshID = id;
+		_chunk->playerEditSections = sections;
 	}
-	if((z + 1) % cw == 0){
-		Chunk* chunk = getChunk(posX, posY, (posZ + 1) % wl);
-		if(chunk) chunk->needsMeshUpdate = true;
+	if(isChunkHidden(_chunk)){
+		// Only chunks of nothing but air or nothing but opaque blocks are hidden
+		_chunk->visibility = _chunk->blocks.get(0) ? 0 : ALL_CHUNK_FACES_CONNECTED;
+		_chunk->visibilityMeshID = id;
+		while(sections){
+			ChunkSection& section = _chunk->sections[std::countr_zero(sections)];
+			sections &= sections - 1;
+			for(auto& faces : section.mesh.faces){
+				faces.resize(0);
+			}
+			section.meshID = id;
+			section.needsUpload = true;
+		}
+		queueVaoUpdate(_chunk, _position);
+		return;
 	}
-	if(y % cw == 0){
-		Chunk* chunk = getChunk(posX, (posY - 1) % wh, posZ);
-		if(chunk) chunk->needsMeshUpdate = true;
+
+	// Copying the block storages only copies their palettes, the workers never see edits made after this
+	MeshRequest request;
+	request.position = _position;
+	request.id = id;
+	request.sections = sections;
+	for(int dy = -1; dy <= 1; dy++){
+		for(int dz = -1; dz <= 1; dz++){
+			for(int dx = -1; dx <= 1; dx++){
+				Chunk* c = getChunk(_position.x + dx, _position.y + dy, _position.z + dz);
+				if(c){
+					request.blocks[((dy + 1) * 9) + ((dz + 1) * 3) + (dx + 1)] = c->blocks;
+				}
+			}
+		}
 	}
-	if((y + 1) % cw == 0){
-		Chunk* chunk = getChunk(posX, (posY + 1) % wh, posZ);
-		if(chunk) chunk->needsMeshUpdate = true;
+	m_meshGenerator.request(std::move(request));
+	m_numMeshesInFlight++;
+}
+
+void World::queueVaoUpdate(Chunk* _chunk, const glm::ivec3& _position){
+	if(!_chunk->needsVaoUpdate){
+		_chunk->needsVaoUpdate = true;
+		m_chunksToUpload.push_back(_position);
 	}
 }
 
-void World::addBlock(Chunk* _c, int _x, int _y, int _z, uint8_t _blockType){
-	BlockTexture blockTexture = m_blockTextureHandler->getTextureFromBlockID(_blockType);
+uint8_t World::getBlock(int _x, int _y, int _z){
+	int cw = CHUNK_WIDTH;
+	int posX = floorDiv(_x, cw);
+	int posY = floorDiv(_y, cw);
+	int posZ = floorDiv(_z, cw);
 
-	addTopFace(_c, _x, _y, _z, blockTexture.top);
-	addBottomFace(_c, _x, _y, _z, blockTexture.bot);
-	addLeftFace(_c, _x, _y, _z, blockTexture.side);
-	addRightFace(_c, _x, _y, _z, blockTexture.side);
-	addFrontFace(_c, _x, _y, _z, blockTexture.side);
-	addBackFace(_c, _x, _y, _z, blockTexture.side);
+	// Blocks in chunks that aren't loaded are treated as air
+	Chunk* chunk = getChunk(posX, posY, posZ);
+	if(!chunk){
+		return 0;
+	}
+	return chunk->getBlock(_x - posX * cw, _y - posY * cw, _z - posZ * cw);
 }
 
-Chunk* World::getChunk(int _x, int _y, int _z) {
-	unsigned int ww = WORLD_WIDTH;
-	unsigned int wl = WORLD_LENGTH;
-	unsigned int wh = WORLD_HEIGHT;
+int World::getSurfaceHeight(int _x, int _z){
+	int cw = CHUNK_WIDTH;
+	int wh = WORLD_HEIGHT;
+	int posX = floorDiv(_x, cw);
+	int posZ = floorDiv(_z, cw);
 
-	if(_y < 0 || _y >= wh || _x < 0 || _x >= ww || _z < 0 || _z >= wl){
-		return nullptr;
+	// Every chunk keeps the heights of its own columns, so we only need the topmost chunk that has a block in this one
+	for(int posY = wh - 1; posY >= 0; posY--){
+		Chunk* chunk = getChunk(posX, posY, posZ);
+		if(!chunk){
+			continue;
+		}
+		int height = chunk->getHeight(_x - posX * cw, _z - posZ * cw);
+		if(height){
+			return posY * cw + height - 1;
+		}
 	}
-	return &m_chunks[(_y * ww * wl) + (_z * ww) + _x];
+	return -1;
 }
 
-unsigned int calcAO(bool side1, bool side2, bool corner, bool face){
-	if(face) return 2;
-	if(side1 && side2){
-		return 0;
+void World::setBlock(int x, int y, int z, uint8_t block, bool _byPlayer) {
+	int cw = CHUNK_WIDTH;
+
+	// Getting the chunk the block is in
+	int posX = floorDiv(x, cw);
+	int posY = floorDiv(y, cw);
+	int posZ = floorDiv(z, cw);
+
+	Chunk* c = getChunk(posX, posY, posZ);
+	if(!c){
+		return;
 	}
-	return 3 - (side1 + side2 + corner);
+
+	// Setting the block based on chunk space coords
+	int localX = x - posX * cw;
+	int localY = y - posY * cw;
+	int localZ = z - posZ * cw;
+	c->setBlock(localX, localY, localZ, block);
+	glm::ivec3 local(localX, localY, localZ);
+	publishEdit(c, local, local, _byPlayer);
 }
 
-bool isBlockTransparent(uint8_t _blockID){
-	return _blockID == 7 || !_blockID;
+// _edit gets called once for every loaded chunk overlapping the region, with the overlap as an inclusive box in chunk space.
+// It returns whether it changed anything, only then an edit covering the overlap gets published
+template<typename Edit>
+void World::editRegion(const glm::ivec3& _min, const glm::ivec3& _max, Edit _edit){
+	int cw = CHUNK_WIDTH;
+	glm::ivec3 minChunk(floorDiv(_min.x, cw), floorDiv(_min.y, cw), floorDiv(_min.z, cw));
+	glm::ivec3 maxChunk(floorDiv(_max.x, cw), floorDiv(_max.y, cw), floorDiv(_max.z, cw));
+
+	for(int y = minChunk.y; y <= maxChunk.y; y++){
+		for(int z = minChunk.z; z <= maxChunk.z; z++){
+			for(int x = minChunk.x; x <= maxChunk.x; x++){
+				Chunk* c = getChunk(x, y, z);
+				if(!c){
+					continue;
+				}
+				glm::ivec3 origin(c->x, c->y, c->z);
+				glm::ivec3 low = glm::max(_min - origin, glm::ivec3(0));
+				glm::ivec3 high = glm::min(_max - origin, glm::ivec3(cw - 1));
+				if(!_edit(c, low, high)){
+					continue;
+				}
+				c->updateHeightmap();
+				publishEdit(c, low, high);
+			}
+		}
+	}
 }
 
-void World::addTopFace(Chunk* c, uint8_t x, uint8_t y, uint8_t z, uint16_t _textureLayer){
-	uint8_t adjacentBlockID = getBlock(c->x + x, c->y + y + 1, c->z + z);
-	if(!isBlockTransparent(adjacentBlockID)) return;
+void World::fillRegion(const glm::ivec3& _min, const glm::ivec3& _max, uint8_t _block){
+	int cw = CHUNK_WIDTH;
 
-	unsigned int a00 = calcAO(getBlock(c->x + x, c->y + y + 1, c->z + z - 1), getBlock(c->x + x - 1, c->y + y + 1, c->z + z), getBlock(c->x + x - 1, c->y + y + 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a01 = calcAO(getBlock(c->x + x - 1, c->y + y + 1, c->z + z), getBlock(c->x + x, c->y + y + 1, c->z + z + 1), getBlock(c->x + x - 1, c->y + y + 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a11 = calcAO(getBlock(c->x + x, c->y + y + 1, c->z + z + 1), getBlock(c->x + x + 1, c->y + y + 1, c->z + z), getBlock(c->x + x + 1, c->y + y + 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a10 = calcAO(getBlock(c->x + x, c->y + y + 1, c->z + z - 1), getBlock(c->x + x + 1, c->y + y + 1, c->z + z), getBlock(c->x + x + 1, c->y + y + 1, c->z + z - 1), adjacentBlockID);
+	editRegion(_min, _max, [cw, _block](Chunk* _c, const glm::ivec3& _low, const glm::ivec3& _high){
+		if(_c->blocks.isUniform() && _c->blocks.get(0) == _block){
+			return false;
+		}
+		// Covering the whole chunk drops its index data instead of writing every block
+		if(_low == glm::ivec3(0) && _high == glm::ivec3(cw - 1)){
+			_c->blocks.fill(_block);
+			return true;
+		}
+		// Rows along x are contiguous in the storage, and full layers are contiguous along z too
+		bool fullRows = _low.x == 0 && _high.x == cw - 1;
+		for(int y = _low.y; y <= _high.y; y++){
+			if(fullRows){
+				_c->blocks.setRun((y * cw * cw) + (_low.z * cw), (_high.z - _low.z + 1) * cw, _block);
+				continue;
+			}
+			for(int z = _low.z; z <= _high.z; z++){
+				_c->blocks.setRun((y * cw * cw) + (z * cw) + _low.x, _high.x - _low.x + 1, _block);
+			}
+		}
+		return true;
+	});
+}
 
-	if(a00 + a11 > a01 + a10) {
-		// Generate normal quad
-		c->vertices.emplace_back(packData(x, y + 1, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a10, 3, _textureLayer));
-	} else {
-		// Generate flipped quad
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-	}
-}
-
-void World::addBottomFace(Chunk* c, uint8_t x, uint8_t y, uint8_t z, uint16_t _textureLayer){
-	uint8_t adjacentBlockID = getBlock(c->x + x, c->y + y - 1, c->z + z);
-	if(!isBlockTransparent(adjacentBlockID)) return;
-
-	unsigned int a00 = calcAO(getBlock(c->x + x, c->y + y - 1, c->z + z - 1), getBlock(c->x + x - 1, c->y + y - 1, c->z + z), getBlock(c->x + x - 1, c->y + y - 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a01 = calcAO(getBlock(c->x + x - 1, c->y + y - 1, c->z + z), getBlock(c->x + x, c->y + y - 1, c->z + z + 1), getBlock(c->x + x - 1, c->y + y - 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a10 = calcAO(getBlock(c->x + x, c->y + y - 1, c->z + z - 1), getBlock(c->x + x + 1, c->y + y - 1, c->z + z), getBlock(c->x + x + 1, c->y + y - 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a11 = calcAO(getBlock(c->x + x, c->y + y - 1, c->z + z + 1), getBlock(c->x + x + 1, c->y + y - 1, c->z + z), getBlock(c->x + x + 1, c->y + y - 1, c->z + z + 1), adjacentBlockID);
-
-	if(a00 + a11 > a01 + a10) {
-		// Generate normal quad
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a11, 2, _textureLayer));
+void World::replaceRegion(const glm::ivec3& _min, const glm::ivec3& _max, uint8_t _from, uint8_t _to){
+	int cw = CHUNK_WIDTH;
+	if(_from == _to){
+		return;
+	}
 
-	} else {
-		// Generate flipped quad
-		c->vertices.emplace_back(packData(x + 1, y, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a01, 1, _textureLayer));
-	}
-}
-
-void World::addRightFace(Chunk* c, uint8_t x, uint8_t y, uint8_t z, uint16_t _textureLayer){
-	uint8_t adjacentBlockID = getBlock(c->x + x - 1, c->y + y, c->z + z);
-	if(!isBlockTransparent(adjacentBlockID)) return;
-
-	unsigned int a00 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z - 1), getBlock(c->x + x - 1, c->y + y - 1, c->z + z), getBlock(c->x + x - 1, c->y + y - 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a01 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z - 1), getBlock(c->x + x - 1, c->y + y + 1, c->z + z), getBlock(c->x + x - 1, c->y + y + 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a10 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z + 1), getBlock(c->x + x - 1, c->y + y - 1, c->z + z), getBlock(c->x + x - 1, c->y + y - 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a11 = calcAO(getBlock(c->x + x - 1, c->y + y + 1, c->z + z), getBlock(c->x + x - 1, c->y + y, c->z + z + 1), getBlock(c->x + x - 1, c->y + y + 1, c->z + z + 1), adjacentBlockID);
-
-
-	if(a00 + a11 > a01 + a10) {
-		// Generate normal quad
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a11, 2, _textureLayer));
-	} else {
-		// Generate flipped quad
-		c->vertices.emplace_back(packData(x, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a01, 1, _textureLayer));
-	}
-}
-
-void World::addLeftFace(Chunk* c, uint8_t x, uint8_t  y, uint8_t z, uint16_t _textureLayer){
-	uint8_t adjacentBlockID = getBlock(c->x + x + 1, c->y + y, c->z + z);
-	if(!isBlockTransparent(adjacentBlockID)) return;
-
-	unsigned int a00 = calcAO(getBlock(c->x + x + 1, c->y + y, c->z + z - 1), getBlock(c->x + x + 1, c->y + y - 1, c->z + z), getBlock(c->x + x + 1, c->y + y - 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a01 = calcAO(getBlock(c->x + x + 1, c->y + y, c->z + z - 1), getBlock(c->x + x + 1, c->y + y + 1, c->z + z), getBlock(c->x + x + 1, c->y + y + 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a10 = calcAO(getBlock(c->x + x + 1, c->y + y, c->z + z + 1), getBlock(c->x + x + 1, c->y + y - 1, c->z + z), getBlock(c->x + x + 1, c->y + y - 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a11 = calcAO(getBlock(c->x + x + 1, c->y + y + 1, c->z + z), getBlock(c->x + x + 1, c->y + y, c->z + z + 1), getBlock(c->x + x + 1, c->y + y + 1, c->z + z + 1), adjacentBlockID);
-
-	if(a00 + a11 > a01 + a10) {
-		// Generate normal quad
-		c->vertices.emplace_back(packData(x + 1, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a10, 3, _textureLayer));
-	} else {
-		// Generate flipped quad
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z, a00, 0, _textureLayer));
-	}
-}
-
-void World::addFrontFace(Chunk* c, uint8_t x, uint8_t y, uint8_t z, uint16_t _textureLayer){
-	uint8_t adjacentBlockID = getBlock(c->x + x, c->y + y, c->z + z - 1);
-	if(!isBlockTransparent(adjacentBlockID)) return;
-
-	unsigned int a00 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z - 1), getBlock(c->x + x, c->y + y - 1, c->z + z - 1), getBlock(c->x + x - 1, c->y + y - 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a01 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z - 1), getBlock(c->x + x, c->y + y + 1, c->z + z - 1), getBlock(c->x + x - 1, c->y + y + 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a10 = calcAO(getBlock(c->x + x, c->y + y - 1, c->z + z - 1), getBlock(c->x + x + 1, c->y + y, c->z + z - 1), getBlock(c->x + x + 1, c->y + y - 1, c->z + z - 1), adjacentBlockID);
-	unsigned int a11 = calcAO(getBlock(c->x + x, c->y + y + 1, c->z + z - 1), getBlock(c->x + x + 1, c->y + y, c->z + z - 1), getBlock(c->x + x + 1, c->y + y + 1, c->z + z - 1), adjacentBlockID);
-
-	if(a00 + a11 > a01 + a10) {
-		// Generate normal quad
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z, a10, 3, _textureLayer));
-	} else {
-		// Generate flipped quad
-		c->vertices.emplace_back(packData(x + 1, y, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z, a11, 2, _textureLayer));
-	}
-}
-
-void World::addBackFace(Chunk* c, uint8_t x, uint8_t y, uint8_t z, uint16_t _textureLayer){
-	uint8_t adjacentBlockID = getBlock(c->x + x, c->y + y, c->z + z + 1);
-	if(!isBlockTransparent(adjacentBlockID)) return;
-
-	unsigned int a00 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z + 1), getBlock(c->x + x, c->y + y - 1, c->z + z + 1), getBlock(c->x + x - 1, c->y + y - 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a01 = calcAO(getBlock(c->x + x - 1, c->y + y, c->z + z + 1), getBlock(c->x + x, c->y + y + 1, c->z + z + 1), getBlock(c->x + x - 1, c->y + y + 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a10 = calcAO(getBlock(c->x + x, c->y + y - 1, c->z + z + 1), getBlock(c->x + x + 1, c->y + y, c->z + z + 1), getBlock(c->x + x + 1, c->y + y - 1, c->z + z + 1), adjacentBlockID);
-	unsigned int a11 = calcAO(getBlock(c->x + x, c->y + y + 1, c->z + z + 1), getBlock(c->x + x + 1, c->y + y, c->z + z + 1), getBlock(c->x + x + 1, c->y + y + 1, c->z + z + 1), adjacentBlockID);
-
-	if(a00 + a11 > a01 + a10) {
-		// Generate normal quad
-		c->vertices.emplace_back(packData(x, y, z + 1, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-	} else {
-		// Generate a flipped quad
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a01, 1, _textureLayer));
-		c->vertices.emplace_back(packData(x, y, z + 1, a00, 0, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y, z + 1, a10, 3, _textureLayer));
-		c->vertices.emplace_back(packData(x + 1, y + 1, z + 1, a11, 2, _textureLayer));
-		c->vertices.emplace_back(packData(x, y + 1, z + 1, a01, 1, _textureLayer));
+	editRegion(_min, _max, [cw, _from, _to](Chunk* _c, const glm::ivec3& _low, const glm::ivec3& _high){
+		if(_c->blocks.isUniform()){
+			if(_c->blocks.get(0) != _from){
+				return false;
+			}
+			if(_low == glm::ivec3(0) && _high == glm::ivec3(cw - 1)){
+				_c->blocks.fill(_to);
+				return true;
+			}
+		}
+		// Every run of matching blocks in a row goes in with a single palette lookup
+		bool changed = false;
+		for(int y = _low.y; y <= _high.y; y++){
+			for(int z = _low.z; z <= _high.z; z++){
+				unsigned int row = (y * cw * cw) + (z * cw);
+				int x = _low.x;
+				while(x <= _high.x){
+					if(_c->blocks.get(row + x) != _from){
+						x++;
+						continue;
+					}
+					int end = x + 1;
+					while(end <= _high.x && _c->blocks.get(row + end) == _from){
+						end++;
+					}
+					_c->blocks.setRun(row + x, end - x, _to);
+					changed = true;
+					x = end;
+				}
+			}
+		}
+		return changed;
+	});
+}
+
+void World::pasteRegion(const glm::ivec3& _origin, const glm::ivec3& _size, const uint8_t* _blocks){
+	int cw = CHUNK_WIDTH;
+	if(_size.x <= 0 || _size.y <= 0 || _size.z <= 0){
+		return;
+	}
+
+	editRegion(_origin, _origin + _size - 1, [cw, &_origin, &_size, _blocks](Chunk* _c, const glm::ivec3& _low, const glm::ivec3& _high){
+		glm::ivec3 offset = glm::ivec3(_c->x, _c->y, _c->z) - _origin;
+		bool changed = false;
+		for(int y = _low.y; y <= _high.y; y++){
+			for(int z = _low.z; z <= _high.z; z++){
+				const uint8_t* row = &_blocks[((y + offset.y) * _size.z * _size.x) + ((z + offset.z) * _size.x) + offset.x];
+				// Runs of the same block in the source go in with a single palette lookup, unless they're already there
+				unsigned int index = (y * cw * cw) + (z * cw);
+				int x = _low.x;
+				while(x <= _high.x){
+					bool differs = _c->blocks.get(index + x) != row[x];
+					int end = x + 1;
+					while(end <= _high.x && row[end] == row[x]){
+						differs |= _c->blocks.get(index + end) != row[end];
+						end++;
+					}
+					if(differs){
+						_c->blocks.setRun(index + x, end - x, row[x]);
+						changed = true;
+					}
+					x = end;
+				}
+			}
+		}
+		return changed;
+	});
+}
+
+bool World::benchmark(const std::vector<uint8_t>& _world){
+	int cw = CHUNK_WIDTH;
+	int ww = WORLD_WIDTH;
+	int wl = WORLD_LENGTH;
+	int wh = WORLD_HEIGHT;
+	int maxW = ww * cw;
+	int maxL = wl * cw;
+	int numChunks = ww * wl * wh;
+
+	// Neither world gets initialised, the edits only need the chunks and the change feed
+	World bulk;
+	World single;
+	std::vector<uint8_t> blocks(CHUNK_SIZE);
+	for(int y = 0; y < wh; y++){
+		for(int z = 0; z < wl; z++){
+			for(int x = 0; x < ww; x++){
+				for(int j = 0; j < cw; j++){
+					for(int k = 0; k < cw; k++){
+						memcpy(&blocks[(j * cw * cw) + (k * cw)], &_world[((y * cw + j) * maxW * maxL) + ((z * cw + k) * maxW) + x * cw], cw);
+					}
+				}
+				for(World* world : { &bulk, &single }){
+					Chunk* c = world->createChunk(x, y, z);
+					c->blocks.load(blocks.data());
+					c->updateHeightmap();
+				}
+			}
+		}
+	}
+	unsigned int subscriber = bulk.m_changeFeed.subscribe();
+
+	// Chunks get unpacked one after another in the same order they were created in
+	auto unpackWorld = [&](World& _world, std::vector<uint8_t>& _blocks){
+		_blocks.resize(numChunks * CHUNK_SIZE);
+		for(int i = 0; i < numChunks; i++){
+			_world.getChunk(i % ww, i / (ww * wl), (i / ww) % wl)->blocks.unpack(&_blocks[i * CHUNK_SIZE]);
+		}
+	};
+
+	// The box starts in the middle of a chunk on x and z and covers both chunk layers, so every chunk it touches gets a different overlap
+	glm::ivec3 min(20, 0, 20);
+	glm::ivec3 size(64);
+	glm::ivec3 max = min + size - 1;
+	glm::ivec3 minChunk = min / cw;
+	glm::ivec3 maxChunk = max / cw;
+
+	bool success = true;
+	std::vector<uint8_t> before;
+	std::vector<uint8_t> bulkAfter;
+	std::vector<uint8_t> singleAfter;
+	std::vector<ChunkChange> changes;
+	auto measure = [&](const char* _name, auto _editRegion, auto _editBlock){
+		unpackWorld(single, before);
+
+		auto start = std::chrono::steady_clock::now();
+		_editRegion();
+		double bulkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for(int y = min.y; y <= max.y; y++){
+			for(int z = min.z; z <= max.z; z++){
+				for(int x = min.x; x <= max.x; x++){
+					_editBlock(x, y, z);
+				}
+			}
+		}
+		double singleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		unpackWorld(bulk, bulkAfter);
+		unpackWorld(single, singleAfter);
+		for(unsigned int i = 0; i < bulkAfter.size(); i++){
+			if(bulkAfter[i] != singleAfter[i]){
+				std::cout << "World: " << _name << ": Block " << i % CHUNK_SIZE << " of chunk " << i / CHUNK_SIZE << " is " << (int)bulkAfter[i] << " instead of " << (int)singleAfter[i] << std::endl;
+				success = false;
+				break;
+			}
+		}
+		for(int z = min.z; z <= max.z; z++){
+			for(int x = min.x; x <= max.x; x++){
+				if(bulk.getSurfaceHeight(x, z) != single.getSurfaceHeight(x, z)){
+					std::cout << "World: " << _name << ": Surface height of column " << x << " " << z << " differs" << std::endl;
+					success = false;
+				}
+			}
+		}
+
+		// Every chunk that changed has to publish a single edit of its overlap with the box, the rest nothing at all
+		changes.clear();
+		bulk.m_changeFeed.poll(subscriber, changes);
+		unsigned int numEdited = 0;
+		for(int i = 0; i < numChunks; i++){
+			glm::ivec3 position(i % ww, i / (ww * wl), (i / ww) % wl);
+			bool changed = memcmp(&before[i * CHUNK_SIZE], &bulkAfter[i * CHUNK_SIZE], CHUNK_SIZE) != 0;
+			glm::ivec3 low = glm::max(min - position * cw, glm::ivec3(0));
+			glm::ivec3 high = glm::min(max - position * cw, glm::ivec3(cw - 1));
+			uint8_t borders = 0;
+			if(low.x == 0) borders |= CHUNK_BORDER_LEFT;
+			if(high.x == cw - 1) borders |= CHUNK_BORDER_RIGHT;
+			if(low.y == 0) borders |= CHUNK_BORDER_BOTTOM;
+			if(high.y == cw - 1) borders |= CHUNK_BORDER_TOP;
+			if(low.z == 0) borders |= CHUNK_BORDER_BACK;
+			if(high.z == cw - 1) borders |= CHUNK_BORDER_FRONT;
+
+			unsigned int numEdits = 0;
+			bool isRightEdit = true;
+			for(auto& change : changes){
+				if(change.position != position){
+					continue;
+				}
+				numEdits++;
+				isRightEdit &= change.type == ChunkChangeType::EDITED && change.min == low && change.max == high && change.borders == borders;
+			}
+			bool isInBox = glm::max(glm::min(position, maxChunk), minChunk) == position;
+			if(numEdits != (unsigned int)changed || !isRightEdit || (changed && !isInBox)){
+				std::cout << "World: " << _name << ": Chunk " << position.x << " " << position.y << " " << position.z << " published " << numEdits << " edits";
+				std::cout << (changed ? " but changed" : " but didn't change") << (isRightEdit ? "" : ", with the wrong box or borders") << std::endl;
+				success = false;
+			}
+			numEdited += changed;
+		}
+
+		std::cout << "World: " << _name << ": " << bulkSeconds * 1000.0 << " ms as a region edit, " << singleSeconds * 1000.0 << " ms with setBlock, ";
+		std::cout << numEdited << " chunks edited" << std::endl;
+	};
+
+	// Replacing the most common block of the box leaves enough of the rest for the paste to differ from
+	unsigned int counts[256] = {};
+	for(int y = min.y; y <= max.y; y++){
+		for(int z = min.z; z <= max.z; z++){
+			for(int x = min.x; x <= max.x; x++){
+				counts[single.getBlock(x, y, z)]++;
+			}
+		}
+	}
+	uint8_t from = std::max_element(counts, counts + 256) - counts;
+	uint8_t to = from == 1 ? 2 : 1;
+	measure("Replace", [&](){ bulk.replaceRegion(min, max, from, to); }, [&](int _x, int _y, int _z){
+		if(single.getBlock(_x, _y, _z) == from){
+			single.setBlock(_x, _y, _z, to);
+		}
+	});
+
+	// Short runs along x with air in between
+	std::vector<uint8_t> pattern(size.x * size.y * size.z);
+	for(int y = 0; y < size.y; y++){
+		for(int z = 0; z < size.z; z++){
+			for(int x = 0; x < size.x; x++){
+				pattern[(y * size.z * size.x) + (z * size.x) + x] = ((x / 5) + (y / 3) + (z / 7)) % 4;
+			}
+		}
+	}
+	auto pasteBlock = [&](int _x, int _y, int _z){
+		single.setBlock(_x, _y, _z, pattern[((_y - min.y) * size.z * size.x) + ((_z - min.z) * size.x) + (_x - min.x)]);
+	};
+	measure("Paste", [&](){ bulk.pasteRegion(min, size, pattern.data()); }, pasteBlock);
+	// Pasting the same blocks again mustn't publish anything
+	measure("Paste again", [&](){ bulk.pasteRegion(min, size, pattern.data()); }, pasteBlock);
+	measure("Fill", [&](){ bulk.fillRegion(min, max, 1); }, [&](int _x, int _y, int _z){
+		single.setBlock(_x, _y, _z, 1);
+	});
+
+	for(World* world : { &bulk, &single }){
+		for(auto& it : world->m_chunks){
+			it.second->destroy();
+			delete it.second;
+		}
+	}
+	return success;
+}
+
+bool World::isChunkHidden(Chunk* _chunk){
+	if(!_chunk->blocks.isUniform()){
+		return false;
+	}
+	uint8_t block = _chunk->blocks.get(0);
+	if(!block){
+		return true; // Nothing but air
+	}
+	if(isBlockTransparent(block)){
+		return false;
+	}
+
+	// A solid chunk only has visible faces where a neighbour lets light through, and unloaded neighbours count as air
+	int cw = CHUNK_WIDTH;
+	int x = floorDiv(_chunk->x, cw);
+	int y = floorDiv(_chunk->y, cw);
+	int z = floorDiv(_chunk->z, cw);
+	Chunk* neighbours[6] = {
+		getChunk(x - 1, y, z),
+		getChunk(x + 1, y, z),
+		getChunk(x, y - 1, z),
+		getChunk(x, y + 1, z),
+		getChunk(x, y, z - 1),
+		getChunk(x, y, z + 1)
+	};
+	for(unsigned int i = 0; i < 6; i++){
+		if(!neighbours[i] || !neighbours[i]->blocks.isUniform() || isBlockTransparent(neighbours[i]->blocks.get(0))){
+			return false;
+		}
+	}
+	return true;
+}
+
+Chunk* World::getChunk(int _x, int _y, int _z) {
+	// Most lookups (meshing, collisions, raycasts) hit the same chunk many times in a row
+	uint64_t key = getChunkKey(_x, _y, _z);
+	if(m_cachedChunk && m_cachedChunkKey == key){
+		return m_cachedChunk;
+	}
+
+	auto it = m_chunks.find(key);
+	if(it == m_chunks.end()){
+		return nullptr;
 	}
+	m_cachedChunk = it->second;
+	m_cachedChunkKey = key;
+	return it->second;
 }
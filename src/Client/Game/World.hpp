@@ -4,48 +4,162 @@
 #include "Camera.hpp"
 #include "Shader.hpp"
 #include "TextureArray.hpp"
-#include "BlockTextureHandler.hpp"
+#include "Settings.hpp"
+#include "RegionStorage.hpp"
+#include "WorldSaver.hpp"
+#include "TerrainGenerator.hpp"
+#include "ChunkChangeFeed.hpp"
+#include "ChunkMesher.hpp"
+#include "MeshGenerator.hpp"
+#include "MultiDrawRenderer.hpp"
+#include "Clock.hpp"
 #include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 
 class World {
 public:
 
-	void init(TextureArray* _array, BlockTextureHandler* _textureHandler);
+	void init(TextureArray* _array, Settings* _settings);
+	void update(const glm::vec3& _playerPosition);
 	void render(Camera& _camera);
 	uint8_t getBlock(int _x, int _y, int _z);
-	void setBlock(int _x, int _y, int _z, uint8_t _block);
+	// Player edits get remeshed before anything else and are used for measuring the edit latency
+	void setBlock(int _x, int _y, int _z, uint8_t _block, bool _byPlayer = false);
+	// Bulk edits of the inclusive box between _min and _max. Chunks that aren't loaded are skipped like in setBlock,
+	// and every edited chunk and neighbour gets marked for a mesh update once instead of once per block
+	void fillRegion(const glm::ivec3& _min, const glm::ivec3& _max, uint8_t _block);
+	void replaceRegion(const glm::ivec3& _min, const glm::ivec3& _max, uint8_t _from, uint8_t _to);
+	// _blocks holds _size.x * _size.y * _size.z blocks laid out as (y * _size.z * _size.x) + (z * _size.x) + x
+	void pasteRegion(const glm::ivec3& _origin, const glm::ivec3& _size, const uint8_t* _blocks);
+
+	// Y of the topmost non-air block in the column, or -1 if the column is all air or not loaded
+	int getSurfaceHeight(int _x, int _z);
 	void destroy();
 
-	void loadWorldFromFile(const std::string& path);
-	void saveWorldToFile(const std::string& path);
-	void updateMeshes();
+	// Queues every edited chunk for the background saver, destroy() waits for the writes to finish
+	void saveWorld();
+	// Hands the most important dirty chunks to the mesh workers: player edits first, then the closest chunks in view
+	void updateMeshes(const Camera& _camera);
+	unsigned int getBlockMemoryUsage() const;
+	unsigned int getNumLoadedChunks() const;
+	// Uploaded faces of every chunk and the buffer memory their ranges take up
+	unsigned int getNumFaces() const;
+	unsigned int getMeshMemoryUsage() const;
+	// Average over every mesh generated so far, in milliseconds
+	double getAverageMeshTime() const;
+	// Meshes the workers haven't handed back yet
+	unsigned int getNumMeshesPending() const;
+	// Time from a player edit until the remeshed chunk got uploaded, in milliseconds
+	double getLastEditLatency() const;
+	double getAverageEditLatency() const;
+	bool isGreedyMeshing() const;
+	// How full and fragmented the mesh arenas are, see ChunkBuffer
+	ChunkBufferStats getMeshBufferStats() const;
+	// CPU time the draw calls of the chunks took in the last render, in milliseconds
+	double getLastDrawTime() const;
+	bool isMultiDrawing() const; // See MultiDrawRenderer
+	// Chunks with faces that were drawn, that were left out by frustum culling and that were in view but hidden
+	// behind other chunks in the last render
+	unsigned int getNumChunksDrawn() const;
+	unsigned int getNumChunksCulled() const;
+	unsigned int getNumChunksOccluded() const;
+	// Every chunk load, edit and unload gets published here, subscribe to process only what changed
+	ChunkChangeFeed& getChangeFeed();
+
+	// Replaces, pastes and fills a 64^3 box across chunk borders of _world with the region edits and with a setBlock loop,
+	// and prints how long both took. _world is in the layout of RegionStorage::readLegacyWorld. Returns false if the two
+	// end up with different blocks, or if a chunk didn't get exactly one edit with the right box and borders when it changed
+	static bool benchmark(const std::vector<uint8_t>& _world);
 
 private:
 
 	// Utility functions
-	void generateMesh(Chunk* chunk);
-	GLuint packData(uint8_t x, uint8_t y, uint8_t z, uint8_t lightLevel, uint8_t textureCoordinateIndex, uint16_t textureArrayIndex);
-	void addBlock(Chunk* _c, int _x, int _y, int _z, uint8_t _blockType);
-	bool isBlockInLocalWorld(int _x, int _y, int _z);
-
-	
-	// Mesh generation functions
-	void addTopFace(Chunk* _c, uint8_t _x, uint8_t _y, uint8_t _z, uint16_t _textureLayer);
-	void addBottomFace(Chunk* _c, uint8_t _x, uint8_t _y, uint8_t _z, uint16_t _textureLayer);
-	void addRightFace(Chunk* _c, uint8_t _x, uint8_t _y, uint8_t _z, uint16_t _textureLayer);
-	void addLeftFace(Chunk* _c, uint8_t _x, uint8_t _y, uint8_t _z, uint16_t _textureLayer);
-	void addFrontFace(Chunk* _c, uint8_t _x, uint8_t _y, uint8_t _z, uint16_t _textureLayer);
-	void addBackFace(Chunk* _c, uint8_t _x, uint8_t _y, uint8_t _z, uint16_t _textureLayer);
+	// Hands a snapshot of the chunk and its neighbours to the mesh workers
+	void requestMesh(Chunk* _chunk, const glm::ivec3& _position);
+	void queueVaoUpdate(Chunk* _chunk, const glm::ivec3& _position);
+	bool isChunkHidden(Chunk* _chunk); // True when the chunk can't have a single visible face
+	// Adds the chunks in view that can be seen from the camera chunk to m_chunksToRender, see ChunkVisibility
+	void findUnoccludedChunks(Chunk* _start);
+
+	// Chunk streaming functions
+	void queueChunkStreaming();
+	bool isChunkInRenderDistance(int _x, int _z, int _margin);
+	Chunk* createChunk(int _x, int _y, int _z);
+	void loadChunk(int _x, int _y, int _z);
+	void addGeneratedChunks();
+	void addChunk(int _x, int _y, int _z, BlockStorage& _blocks);
+	void destroyChunk(int _x, int _y, int _z);
+	// _low and _high are the inclusive box of the edited blocks, in chunk space
+	void publishEdit(Chunk* _c, const glm::ivec3& _low, const glm::ivec3& _high, bool _byPlayer = false);
+	void queueMeshUpdate(int _x, int _y, int _z, uint64_t _sections, bool _isUrgent);
+	float getMeshPriority(Chunk* _chunk, const Camera& _camera);
+	void uploadMesh(Chunk* _chunk);
+	template<typename Edit>
+	void editRegion(const glm::ivec3& _min, const glm::ivec3& _max, Edit _edit);
+
 	Chunk* getChunk(int x, int y, int z);
 
-	//We keep vertices so we dont have to reallocate memory every time we want to generate a chunk
-	Shader m_shader;
-	unsigned int m_data_length = 0;
+	Shader m_shaders[NUM_CHUNK_PASSES]; // One per pass, see CHUNK_PASS_OPAQUE
+	Uniform<glm::vec3> m_chunkPositionUniforms[NUM_CHUNK_PASSES]; // Only in the shaders without multi draw
+	Uniform<bool> m_greedyMeshingUniforms[NUM_CHUNK_PASSES];
+	ChunkBuffer m_chunkBuffer; // Holds the meshes of every chunk
+	MultiDrawRenderer m_multiDrawRenderer;
+	bool m_isMultiDrawing = false;
+	double m_lastDrawTime = 0.0; // In seconds
+	MeshGenerator m_meshGenerator;
+	std::vector<MeshResult> m_meshResults; // Reused for collecting finished meshes
+	uint64_t m_nextMeshID = 0;
+	// Frustum culling variables, the lowest corners of all chunks are kept as separate arrays for Frustum::cullCubes
+	std::vector<Chunk*> m_chunksToRender;
+	std::vector<Chunk*> m_cullChunks; // In the same order as the corners
+	std::vector<float> m_cullX;
+	std::vector<float> m_cullY;
+	std::vector<float> m_cullZ;
+	std::vector<uint8_t> m_cullVisible;
+	unsigned int m_numChunksDrawn = 0;
+	unsigned int m_numChunksCulled = 0;
+	unsigned int m_numChunksOccluded = 0;
+	// Occlusion culling variables, every step is a chunk the walk from the camera chunk went into
+	struct OcclusionStep {
+		Chunk* chunk;
+		unsigned int entryFace; // NO_ENTRY_FACE for the camera chunk
+		uint8_t directions; // Faces the walk went out through so far, one bit per face
+	};
+	std::vector<OcclusionStep> m_occlusionQueue;
+	unsigned int m_numMeshesInFlight = 0;
+	std::vector<std::pair<float, glm::ivec3>> m_meshQueue; // Reused for sorting m_chunksToMesh by priority
+	Clock m_worldClock; // Started in init, used for timing player edits
+	double m_lastEditLatency = 0.0; // In seconds
+	double m_totalEditLatency = 0.0;
+	unsigned int m_numEditLatencies = 0;
 
 	TextureArray* m_textureArray = nullptr;
-	BlockTextureHandler* m_blockTextureHandler = nullptr;
-	Chunk* m_chunks = nullptr;
-	uint8_t* m_data = nullptr;
+	Settings* m_settings = nullptr;
+	RegionStorage m_regionStorage;
+	WorldSaver m_worldSaver;
+	TerrainGenerator m_terrainGenerator;
+	std::unordered_set<uint64_t> m_chunksGenerating; // Requested from the terrain generator but not added yet
+	std::vector<GeneratedChunk> m_generatedChunks;
+	Clock m_autosaveTimer;
+
+	// Chunks are keyed by their chunk coordinates so the world doesn't need fixed dimensions
+	std::unordered_map<uint64_t, Chunk*> m_chunks;
+	Chunk* m_cachedChunk = nullptr;
+	uint64_t m_cachedChunkKey = 0;
+
+	// Change feed variables, meshing and saving are both subscribers
+	ChunkChangeFeed m_changeFeed;
+	unsigned int m_meshSubscriber = 0;
+	unsigned int m_saveSubscriber = 0;
+	std::vector<ChunkChange> m_changes; // Reused for polling the feed
+	std::vector<glm::ivec3> m_chunksToMesh;
+	std::vector<glm::ivec3> m_chunksToUpload;
 
+	// Streaming variables
+	glm::ivec3 m_streamingCenter;
+	bool m_hasStreamingCenter = false;
+	std::vector<glm::ivec3> m_chunksToLoad;
+	std::vector<glm::ivec3> m_chunksToUnload;
 
 };
@@ -0,0 +1,83 @@
+#include "WorldSaver.hpp"
+#include <iostream>
+
+void WorldSaver::init(RegionStorage* _regionStorage){
+	m_regionStorage = _regionStorage;
+	m_isRunning = true;
+	m_thread = std::thread(&WorldSaver::run, this);
+}
+
+void WorldSaver::queue(int _x, int _y, int _z, const BlockStorage& _blocks){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		// An older snapshot of the same chunk that hasn't been written yet is simply replaced, the one being written is left alone
+		for(unsigned int i = m_isWriting; i < m_queue.size(); i++){
+			ChunkSnapshot& snapshot = m_queue[i];
+			if(snapshot.x == _x && snapshot.y == _y && snapshot.z == _z){
+				snapshot.blocks = _blocks;
+				return;
+			}
+		}
+		m_queue.push_back({ _x, _y, _z, _blocks });
+	}
+	m_queueCondition.notify_one();
+}
+
+bool WorldSaver::getPending(int _x, int _y, int _z, BlockStorage& _blocks){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// Searching from the back since the newest snapshot of a chunk is the one that matters
+	for(auto it = m_queue.rbegin(); it != m_queue.rend(); it++){
+		if(it->x == _x && it->y == _y && it->z == _z){
+			_blocks = it->blocks;
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorldSaver::flush(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_flushCondition.wait(lock, [this](){ return m_queue.empty() && !m_isWriting; });
+}
+
+void WorldSaver::destroy(){
+	if(!m_thread.joinable()) return;
+	flush();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+	}
+	m_queueCondition.notify_one();
+	m_thread.join();
+}
+
+unsigned int WorldSaver::getNumPending(){
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_queue.size() + m_isWriting;
+}
+
+void WorldSaver::run(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(true){
+		m_queueCondition.wait(lock, [this](){ return !m_queue.empty() || !m_isRunning; });
+		if(m_queue.empty()) break;
+
+		// The snapshot stays in the queue while it's written so getPending can still hand it out
+		ChunkSnapshot& snapshot = m_queue.front();
+		int x = snapshot.x;
+		int y = snapshot.y;
+		int z = snapshot.z;
+		BlockStorage blocks = snapshot.blocks;
+		m_isWriting = true;
+		lock.unlock();
+
+		if(!m_regionStorage->saveChunk(x, y, z, blocks)){
+			std::cout << "WorldSaver: Failed to save chunk " << x << " " << y << " " << z << std::endl;
+		}
+
+		lock.lock();
+		m_isWriting = false;
+		m_queue.pop_front();
+		if(m_queue.empty()) m_flushCondition.notify_all();
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "BlockStorage.hpp"
+#include "RegionStorage.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+// Writes chunk snapshots to the region files on a background thread so saving never stalls a frame.
+// Snapshots are copies of a chunk's BlockStorage, which share their packed indices with the live chunk
+// until the next edit, so queueing one is about as cheap as copying its palette.
+class WorldSaver {
+public:
+
+	void init(RegionStorage* _regionStorage);
+	void queue(int _x, int _y, int _z, const BlockStorage& _blocks);
+	// Chunks that get reloaded before their save went through have to come from here, the region file is still stale
+	bool getPending(int _x, int _y, int _z, BlockStorage& _blocks);
+	// Blocks until every queued snapshot is written
+	void flush();
+	void destroy();
+
+	unsigned int getNumPending();
+
+private:
+
+	struct ChunkSnapshot {
+		int x, y, z;
+		BlockStorage blocks;
+	};
+
+	void run();
+
+	RegionStorage* m_regionStorage = nullptr;
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_queueCondition; // Signaled when a snapshot gets queued or the saver should stop
+	std::condition_variable m_flushCondition; // Signaled when the queue runs empty
+	std::deque<ChunkSnapshot> m_queue;
+	bool m_isWriting = false;
+	bool m_isRunning = false;
+
+};
@@ -1,7 +1,52 @@
 #include "Program.hpp"
+#include "TerrainGenerator.hpp"
+#include "RegionStorage.hpp"
+#include "MeshGenerator.hpp"
+#include "World.hpp"
+#include "FilePathManager.hpp"
 #include <iostream>
+#include <cstring>
 
-int main(){
+// The benchmarks that compare against the layouts and meshers we replaced run on the blocks of lobby.dat
+bool readLobby(std::vector<uint8_t>& _world){
+	FilePathManager::init();
+	return RegionStorage::readLegacyWorld(FilePathManager::getRootFolderDirectory() + "lobby.dat", _world);
+}
+
+int main(int argc, char** argv){
+
+	// Measures terrain generation throughput instead of starting the game
+	if(argc > 1 && !strcmp(argv[1], "--benchmark-terrain")){
+		TerrainGenerator::benchmark(argc > 2 ? atoi(argv[2]) : 1337, 2048);
+		return 0;
+	}
+
+	// Compares the chunk block storage against the flat array it replaced
+	if(argc > 1 && !strcmp(argv[1], "--benchmark-storage")){
+		std::vector<uint8_t> world;
+		if(!readLobby(world)){
+			return 1;
+		}
+		return BlockStorage::benchmark(world) ? 0 : 1;
+	}
+
+	// Compares meshing from the padded buffer against looking up every block and against the greedy mesher, fails if they don't give the same faces
+	if(argc > 1 && !strcmp(argv[1], "--benchmark-mesher")){
+		std::vector<uint8_t> world;
+		if(!readLobby(world)){
+			return 1;
+		}
+		return MeshGenerator::benchmark(world) ? 0 : 1;
+	}
+
+	// Compares the region edits against setting every block on its own, fails if they don't give the same world and edits
+	if(argc > 1 && !strcmp(argv[1], "--benchmark-region-edits")){
+		std::vector<uint8_t> world;
+		if(!readLobby(world)){
+			return 1;
+		}
+		return World::benchmark(world) ? 0 : 1;
+	}
 
 	srand(time(0));
 
@@ -9,6 +9,9 @@ const int WORLD_HEIGHT = 2;
 const int WORLD_LENGTH = 4;
 const int CHUNK_WIDTH = 32;
 const int CHUNK_SIZE = CHUNK_WIDTH * CHUNK_WIDTH * CHUNK_WIDTH;
+const int CHUNK_SECTION_WIDTH = 16; // Chunks get meshed and uploaded in cubes of this size, has to divide CHUNK_WIDTH
+const int CHUNK_SECTIONS_PER_AXIS = CHUNK_WIDTH / CHUNK_SECTION_WIDTH;
+const int CHUNK_NUM_SECTIONS = CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS;
 const int CLIENT_PORT = 7459;
 const int SERVER_PORT = 7456;
 const int PACKET_TRANSMISSION_FREQUENCY = 10;